@@ -26,6 +26,21 @@
 
 #include "netif.h"
 
+#include "adc_capture.h"
+#include "frame_queue.h"
+#include "frame_pool.h"
+#include "stream_session.h"
+#include "decimator.h"
+#include "sample_convert.h"
+#include "channel_align.h"
+#include "capture_source.h"
+#include "packetizer.h"
+#include "fec.h"
+#include "retx.h"
+#include "stream_dest.h"
+#include "rtcp.h"
+#include "sock_event.h"
+
 #include "azure_samples.h"
 
 #include "hardware/gpio.h"
@@ -55,6 +70,8 @@
 #define UDP_PORT 30000
 #define UDP_SPORT 30001
 #define TCP_C_SOCKET 2
+#define RTCP_SOCKET 2 //the TCP client is not used while streaming
+#define MCAST_SOCKET 3 //DNS and SNTP only run at boot
 
 
 //adc define
@@ -65,6 +82,32 @@
 #define ADC_CONVERT (ADC_VREF / (ADC_RANGE - 1))
 #define ADC_CLK_VAL  2999
 
+//core1 capture, attach and detach carry the slot in bits 8 ~ 15
+#define CORE1_CMD_START 1
+#define CORE1_CMD_STOP 2
+#define CORE1_CMD_ATTACH 3
+#define CORE1_CMD_DETACH 4
+#define CORE1_CMD_MASK 0xFF
+#define CORE1_CMD_SLOT_SHIFT 8
+
+//stream sessions, one per control host, all fed by the same capture
+#define STREAM_SLOT_MAX 3 //recorder, live monitor, analyzer
+#define STREAM_SLOT_NACK_MAX 1 //sessions with nack=1, each keeps RETX_HISTORY_DEPTH frames out of the pool
+#define STREAM_SLOT_QUEUE_MAX ((FRAME_POOL_QUEUE_FRAMES / STREAM_SLOT_MAX) - 1) //packets queued per session, plus the one being filled
+
+#if (FRAME_POOL_RETX_FRAMES < STREAM_SLOT_NACK_MAX * RETX_HISTORY_DEPTH) || (FRAME_POOL_SENT_FRAMES < STREAM_SLOT_MAX) || \
+    (STREAM_SLOT_QUEUE_MAX < 1) || (STREAM_SLOT_QUEUE_MAX > FRAME_QUEUE_DEPTH)
+#error "frame pool too small for the stream sessions"
+#endif
+
+//stream state
+#define SEND_STATUS_STOP 0
+#define SEND_STATUS_RUN 1
+#define SEND_STATUS_PAUSE 2 //continuous stream, capture keeps running until the receiver is back
+
+//control channel heartbeat
+#define HEARTBEAT_PERIOD_MS 1000
+
 /**
   * ----------------------------------------------------------------------------------------------------
   * Variables
@@ -95,17 +138,6 @@ typedef struct TCP_S_RSV_DATA_1
 	uint8_t *RCV_DATA;
 }TCP_S_RSV_DATA;
 
-typedef struct ADC_DATA_STATUS_t
-{
-    uint8_t sendPosition;
-    uint8_t sendFlag;
-    uint8_t sendComplete;
-    uint8_t inputPosition;
-    uint16_t dataCount;
-    uint8_t sendStatus;
-    uint8_t DATA[2][2048];
-}ADC_DATA_STATUS;
-
 typedef union h2f_var_t
 {
     uint32_t hdata;
@@ -114,8 +146,49 @@ typedef union h2f_var_t
 
 /* Timer */
 static uint16_t g_msec_cnt = 0;
+static uint16_t g_heartbeat_msec_cnt = 0;
+static volatile uint8_t g_heartbeat_flag = 0;
+
+typedef struct stream_slot_t
+{
+    uint8_t owner[4];             //control host, the table key
+    uint8_t status;               //SEND_STATUS_xxx
+    uint8_t attended;             //owner was on the control connection at the last heartbeat
+    stream_session_t session;     //written by core0 before CORE1_CMD_ATTACH
+    frame_queue_t queue;          //core1 packets -> core0 send
+    packetizer_t packetizer;      //core1
+    sample_convert_t convert;     //core1, wire format and gain of this session
+    fec_t fec;                    //core0, XOR parity for fec=n
+    retx_t retx;                  //core0, sent frame history for nack=1
+    stream_dest_t dest;           //core0
+    frame_t *sent_frame;          //core0, last frame sent, may still be going out by SPI DMA
+    uint32_t send_count;
+    uint64_t send_index;
+    wiz_SPIStat spi_start;        //core0, chip access counters when the stream started
+} stream_slot_t;
 
-ADC_DATA_STATUS adc_data;
+/* Stream sessions, core1 only feeds attached slots */
+static stream_slot_t g_slot[STREAM_SLOT_MAX];
+static volatile uint8_t g_slot_attached[STREAM_SLOT_MAX];
+static volatile uint8_t g_slot_detached[STREAM_SLOT_MAX]; //set by core1 once CORE1_CMD_DETACH is done
+
+/* Capture shared by all sessions, taken from the first one on CORE1_CMD_START */
+static stream_session_t g_capture;
+
+/* RTCP for proto=rtp, driven by core0 next to the RTP sender. One RTP stream and one socket */
+static rtcp_t g_rtcp;
+static char g_rtcp_cname[RTCP_CNAME_MAX_LEN + 1];
+static int8_t g_rtcp_slot = -1;
+
+/* Core1 oversampling and channel alignment, shared */
+static channel_align_t g_align;
+
+/* Core1 capture source, selected by the session on CORE1_CMD_START */
+static const capture_source_t *volatile g_source = 0;
+static decimator_t g_decimator;
+
+/* Socket events reported through INTn, taken by the main loop */
+static uint8_t g_sock_events[_WIZCHIP_SOCK_NUM_];
 
 /**
   * ----------------------------------------------------------------------------------------------------
@@ -125,6 +198,21 @@ ADC_DATA_STATUS adc_data;
 /* Timer callback */
 static void repeating_timer_callback(void);
 
+/* Core1 */
+static void core1_entry(void);
+
+/* Socket events */
+static void sock_event_callback(uint8_t sn, uint8_t events);
+
+/* Stream sessions */
+static int8_t stream_slot_find(const uint8_t *owner, uint8_t alloc);
+static uint8_t stream_slot_running(int8_t except);
+static int8_t stream_slot_check(int8_t index, const stream_session_t *session);
+static int8_t stream_slot_start(int8_t index);
+static void stream_slot_stop(int8_t index);
+static void stream_slot_send(int8_t index);
+static stream_slot_t *stream_slot_find_nack(const uint8_t *ip);
+
 uint16_t TCP_Server(uint8_t sn, uint16_t port);
 uint16_t TCP_client(uint8_t sn, uint8_t* destip, uint16_t destport);
 
@@ -150,6 +238,7 @@ int main()
     uint8_t *tcp_rcv_data = 0;
     uint16_t tcp_rcv_size = 0;
     uint8_t UDP_BroadIP[4] = {255,255,255,255};
+    uint8_t requester_ip[4] = {0,};
     int32_t UDP_ret = 0;
     uint8_t TCP_Client_DestIp[4] = {192, 168, 0, 3};
     uint16_t TCP_Client_Port = 22000;
@@ -157,21 +246,27 @@ int main()
     uint8_t *tcp_c_rcv_data = 0;
     uint16_t tcp_c_rcv_size = 0;
     int tcp_c_ret = 0;
-    uint16_t udp_send_port = 30001;
-
-    //int8_t mic_Data[2048];
-    int8_t mic_Data[200000];
-    
-    uint32_t mic_cnt = 0;
-    uint8_t data_send_status = 0;
-    uint32_t send_count = 0;
-    
-    uint16_t adc_raw = 0;
-    uint16_t adc_raw1 = 0;
-    uint32_t i= 0;
-
-    memset(&adc_data, 0, sizeof(ADC_DATA_STATUS));
-    adc_data.sendComplete = 1;
+
+    stream_session_t next_session;
+    stream_slot_t *slot = 0;
+    int8_t slot_index = 0;
+    uint8_t control_ip[4] = {0,};
+    uint8_t link_ok = 0;
+    uint8_t control_ok = 0;
+    uint8_t receiver_ok = 0;
+    static const rtcp_report_t no_report = {0,};
+    const rtcp_report_t *report = 0;
+    uint8_t i = 0;
+    uint32_t sntp_time = 0;
+    char hb_msg[96];
+    int hb_size = 0;
+    uint8_t udp_poll = 1;
+    uint8_t tcp_s_poll = 1;
+    uint8_t tcp_s_recv = 0;
+
+    //clk_peri at the PLL rate lets SPI run up to 66.5MHz, set before the UART takes its baud rate from it
+    set_clock_khz();
+
     stdio_init_all();
 
     wizchip_delay_ms(1000 * 3); // wait for 3 seconds
@@ -182,6 +277,7 @@ int main()
     wizchip_reset();
     wizchip_initialize();
     wizchip_check();
+    wizchip_spi_tune();
 
     wizchip_1ms_timer_initialize(repeating_timer_callback);
 
@@ -191,26 +287,19 @@ int main()
     sleep_ms(1000);
     //printf("Starting Program\n");
 #if 1
-    adc_init();
-    adc_gpio_init( ADC_PIN);
-    adc_select_input( ADC_NUM);
-    //sleep_ms(1000);
     printf("Starting Program\n");
-    //adc fifo 
-    
-    adc_fifo_setup(
-        true,    // Write each completed conversion to the sample FIFO
-        true,    // Enable DMA data request (DREQ)
-        1,       // DREQ (and IRQ) asserted when at least 1 sample present
-        true,   // We won't see the ERR bit because of 8 bit reads; disable.
-        false     // Shift each sample to 8 bits when pushing to FIFO
-    );
-    adc_set_clkdiv(ADC_CLK_VAL);//2999= 16kS/s 1499 = 32kS/s (1+999)/48Mhz = 48kS/s   199=240kS/s  239=200kS/s 1087=44118S/s
+    //core1 owns adc dma capture and sample conversion
+    for(i = 0; i < STREAM_SLOT_MAX; i++)
+    {
+        stream_session_default(&g_slot[i].session);
+        frame_queue_init(&g_slot[i].queue);
+    }
+    stream_session_default(&g_capture);
+    frame_pool_initialize();
+    multicore_launch_core1(core1_entry);
     sleep_ms(1000);
-    printf("Starting capture %d\n", 48000000/(1+ADC_CLK_VAL));
-    adc_run(true);
+    stream_session_print(&g_capture);
     #endif
-    //multicore_launch_core1(core1_entry);
 #ifdef _DHCP
     // this example uses DHCP
     networkip_setting = wizchip_network_initialize(true, &g_net_info);
@@ -224,6 +313,16 @@ int main()
     if (networkip_setting)
     {
 //-----------------------------------------------------------------------------------
+        //wallclock for RTCP sender reports, without it they carry the time since boot
+        wizchip_sntp_init();
+        sntp_time = (uint32_t)wizchip_sntp_get_current_timestamp();
+        if(sntp_time != 0)
+        {
+            rtcp_set_wallclock(sntp_time);
+            printf(" SNTP time %lu\n", sntp_time);
+        }
+        snprintf(g_rtcp_cname, sizeof(g_rtcp_cname), "mic@%d.%d.%d.%d", g_net_info.ip[0], g_net_info.ip[1], g_net_info.ip[2], g_net_info.ip[3]);
+//-----------------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------------
 // CALL Main Funcion - Azure IoT SDK example funcion
@@ -249,6 +348,11 @@ int main()
     else
         printf(" Check your network setting.\n");
 
+    //control and data sockets report through INTn instead of being polled every loop
+    sock_event_initialize();
+    sock_event_register(TCP_S_SOCKET, SOCK_EVENT_CON | SOCK_EVENT_DISCON | SOCK_EVENT_RECV | SOCK_EVENT_TIMEOUT, sock_event_callback);
+    sock_event_register(UDP_SOCKET, SOCK_EVENT_RECV, sock_event_callback);
+
     //adc test
     /* Infinite loop */
     for (;;)
@@ -270,40 +374,86 @@ int main()
         //adc fifo
         //adc_raw = adc_fifo_get_blocking();
         #if 1
-        if(data_send_status == 1)
+        for(i = 0; i < STREAM_SLOT_MAX; i++)
         {
-            for(i= 0; i<250; i++)
-            {
-                adc_raw = adc_fifo_get_blocking();
-                adc_raw1 = (adc_raw&0x0fff) - (1<<10);
-                mic_Data[mic_cnt++] = adc_raw1 & 0x00ff;
-                mic_Data[mic_cnt++] = (adc_raw1 >> 8) & 0x00ff;
-            }
-            mic_cnt = 0;
-            send_count++;
-            sendto(UDP_SOCKET, mic_Data, 500, UDP_BroadIP, udp_send_port);
+            stream_dest_poll(&g_slot[i].dest);
+            stream_slot_send(i);
         }
-        
-        if(send_count >= 2000)  
+
+        //sender reports keep going while paused, receiver reports carry loss, jitter and RTT
+        if((g_rtcp_slot >= 0) && rtcp_run(&g_rtcp))
+        {
+            printf("RR %08lx lost %d/256 (%ld), jitter %lu us, rtt %lu us\r\n", g_rtcp.report.ssrc, g_rtcp.report.fraction_lost,
+                   g_rtcp.report.cumulative_lost, g_rtcp.report.jitter_us, g_rtcp.report.rtt_us);
+        }
+
+        if(g_heartbeat_flag)
         {
-            UDP_ret = sendto(UDP_SOCKET, "STOP", 5, UDP_BroadIP, udp_send_port);
-            printf("send finish %d\r\n", send_count);
-            data_send_status = 0;
-            send_count = 0;
-            adc_run(false);
+            g_heartbeat_flag = 0;
+
+            //a bus error takes the SPI clock one step down
+            wizchip_spi_check();
+
+            //a continuous stream pauses while the link is down or its host drops the control connection
+            link_ok = (wizphy_getphylink() == PHY_LINK_ON);
+            control_ok = link_ok && (getSn_SR(TCP_S_SOCKET) == SOCK_ESTABLISHED);
+            if(control_ok)
+                getSn_DIPR(TCP_S_SOCKET, control_ip);
+            for(i = 0; i < STREAM_SLOT_MAX; i++)
+            {
+                slot = &g_slot[i];
+                receiver_ok = control_ok && (memcmp(slot->owner, control_ip, 4) == 0);
+                if((slot->status == SEND_STATUS_RUN) && (slot->session.packet_limit == 0) && (!link_ok || (slot->attended && !receiver_ok)))
+                {
+                    printf("receiver %d lost, pause at %llu\r\n", i, slot->send_index);
+                    slot->status = SEND_STATUS_PAUSE;
+                }
+                else if((slot->status == SEND_STATUS_PAUSE) && receiver_ok)
+                {
+                    printf("receiver %d back, resume\r\n", i);
+                    slot->status = SEND_STATUS_RUN;
+                }
+                slot->attended = receiver_ok;
+
+                //nonblocking, a busy socket just skips this beat
+                if((slot->status == SEND_STATUS_RUN) && receiver_ok)
+                {
+                    report = (i == g_rtcp_slot) ? &g_rtcp.report : &no_report;
+                    hb_size = sprintf(hb_msg, "HB %llu %lu %lu %d %lu %lu\r\n", slot->send_index, slot->send_count, slot->packetizer.drop,
+                                      report->fraction_lost, report->jitter_us, report->rtt_us);
+                    send(TCP_S_SOCKET, hb_msg, hb_size);
+                }
+            }
         }
         
         #endif
         //printf("%.2f\n", adc_raw * ADC_CONVERT);
 
         //TCP_C_status =TCP_client(TCP_C_SOCKET, TCP_Client_DestIp, TCP_Client_Port);
-        UDP_S_status = udps_status(UDP_SOCKET, UDP_buff, UDP_PORT);
-        TCP_S_status = TCP_Server(TCP_S_SOCKET, TCP_S_PORT);
-        if(TCP_S_status == 17)
+        //sockets are only looked at after an event, or while they step through open, listen and close
+        sock_event_dispatch();
+        if(udp_poll || g_sock_events[UDP_SOCKET])
+        {
+            g_sock_events[UDP_SOCKET] = 0;
+            UDP_S_status = udps_status(UDP_SOCKET, UDP_buff, UDP_PORT);
+            //one datagram per call, go on until the RX buffer is empty
+            udp_poll = (UDP_S_status != SOCK_UDP) || (getSn_RX_RSR(UDP_SOCKET) != 0);
+        }
+        if(tcp_s_poll || g_sock_events[TCP_S_SOCKET])
+        {
+            if(g_sock_events[TCP_S_SOCKET] & (SOCK_EVENT_CON | SOCK_EVENT_RECV))
+                tcp_s_recv = 1;
+            g_sock_events[TCP_S_SOCKET] = 0;
+            TCP_S_status = TCP_Server(TCP_S_SOCKET, TCP_S_PORT);
+            tcp_s_poll = (TCP_S_status != 17) && (TCP_S_status != SOCK_LISTEN);
+        }
+        if((TCP_S_status == 17) && tcp_s_recv)
         {
             //TCP_Server_Buf = TCP_S_Recv(TCP_S_SOCKET);
             //tcp_rcv_data = TCP_S_Recv(TCP_S_SOCKET);
             tcp_rcv_data = TCP_S_Recv(TCP_S_SOCKET, &tcp_rcv_size);
+            //one read per call, go on until nothing is left
+            tcp_s_recv = (tcp_rcv_data != 0);
             if(tcp_rcv_data != 0)
             {
                 printf("rcv[%d] : %s \r\n",tcp_rcv_size, tcp_rcv_data);
@@ -315,23 +465,43 @@ int main()
                         printf("sendto Error \r\n");
                     }
                 }
+                //sessions are keyed by the host on the other end of the control connection
+                getSn_DIPR(TCP_S_SOCKET, requester_ip);
+                slot_index = stream_slot_find(requester_ip, strncmp(tcp_rcv_data, "start", 5) == 0);
                 if(strncmp(tcp_rcv_data, "start", 5) == 0)
                 {
                     printf(" data  send start[%s]\r\n", tcp_rcv_data + 6);
-                    udp_send_port = atoi(tcp_rcv_data + 6);
-                    printf("recv port = %d \r\n", udp_send_port);
-                    //UDP_ret = sendto(UDP_SOCKET, "START", 5, UDP_BroadIP, UDP_SPORT);
-                    adc_run(true);
-                    adc_fifo_drain();
-                    data_send_status = 1;
-                    //adc_data.sendStatus = 1;
+                    if(slot_index >= 0)
+                        memcpy(&next_session, &g_slot[slot_index].session, sizeof(stream_session_t));
+                    if(slot_index < 0)
+                    {
+                        printf("no free session \r\n");
+                    }
+                    else if(stream_session_parse(&next_session, tcp_rcv_data) != 0)
+                    {
+                        printf("invalid start command \r\n");
+                    }
+                    else if((g_slot[slot_index].status != SEND_STATUS_STOP) && (g_slot[slot_index].session.packet_limit == 0) &&
+                            (memcmp(&next_session, &g_slot[slot_index].session, sizeof(stream_session_t)) == 0))
+                    {
+                        //same continuous session, keep capturing so the sample index continues
+                        printf("resume continuous stream %d at %llu\r\n", slot_index, g_slot[slot_index].send_index);
+                        g_slot[slot_index].status = SEND_STATUS_RUN;
+                    }
+                    else if(stream_slot_check(slot_index, &next_session) == 0)
+                    {
+                        //restart with the new session parameters
+                        stream_slot_stop(slot_index);
+                        memcpy(g_slot[slot_index].owner, requester_ip, 4);
+                        memcpy(&g_slot[slot_index].session, &next_session, sizeof(stream_session_t));
+                        stream_slot_start(slot_index);
+                    }
                 }
                 else if(strncmp(tcp_rcv_data, "stop", 4) == 0)
                 {
                     printf("data send stop \r\n");
-                    data_send_status = 0;
-                    //adc_data.sendStatus = 0;
-                    adc_run(false);
+                    if(slot_index >= 0)
+                        stream_slot_stop(slot_index);
                 }
                 free(tcp_rcv_data);
             }
@@ -357,6 +527,12 @@ static void repeating_timer_callback(void)
 {
     g_msec_cnt++;
 
+    if (++g_heartbeat_msec_cnt >= HEARTBEAT_PERIOD_MS)
+    {
+        g_heartbeat_msec_cnt = 0;
+        g_heartbeat_flag = 1;
+    }
+
 #ifdef _DHCP
     if (g_msec_cnt >= 1000 - 1)
     {
@@ -367,6 +543,356 @@ static void repeating_timer_callback(void)
 #endif
 }
 
+/* Socket events : called from sock_event_dispatch() in the main loop */
+static void sock_event_callback(uint8_t sn, uint8_t events)
+{
+    g_sock_events[sn] |= events;
+}
+
+/* Core1 : adc capture and sample conversion */
+static void core1_entry(void)
+{
+    const void *cap_frame;
+    uint32_t cap_cnt;
+    capture_source_config_t cap_config;
+    int16_t dec_out[ADC_CAPTURE_FRAME_SAMPLES_MAX / DECIMATOR_FACTOR + 1];
+    uint32_t dec_cnt;
+    uint64_t cap_time;
+    uint64_t cap_index;
+    uint32_t cmd;
+    uint8_t index;
+    uint8_t i;
+
+    //dma irq is taken on the core that registers it, pio sources are set up on first use
+    adc_capture_initialize(ADC_NUM, ADC_CLK_VAL);//2999= 16kS/s 1499 = 32kS/s (1+999)/48Mhz = 48kS/s   199=240kS/s  239=200kS/s 1087=44118S/s
+    g_source = capture_source_open(CAPTURE_SOURCE_ADC);
+
+    for (;;)
+    {
+        if(multicore_fifo_rvalid())
+        {
+            cmd = multicore_fifo_pop_blocking();
+            index = (uint8_t)(cmd >> CORE1_CMD_SLOT_SHIFT);
+            switch(cmd & CORE1_CMD_MASK)
+            {
+                case CORE1_CMD_START :
+                    decimator_init(&g_decimator);
+                    channel_align_init(&g_align, g_capture.channels);
+                    cap_config.sample_rate = g_capture.actual_rate;
+                    cap_config.clkdiv = g_capture.clkdiv;
+                    cap_config.capture_samples = g_capture.capture_samples;
+                    cap_config.channels = g_capture.channels;
+                    g_source = capture_source_open(g_capture.source);
+                    //the rate the source really runs at, the sessions were set up with the same rounding
+                    g_capture.actual_rate = g_source->configure(&cap_config);
+                    g_source->start();
+                    break;
+                case CORE1_CMD_STOP :
+                    g_source->stop();
+                    break;
+                case CORE1_CMD_ATTACH :
+                    sample_convert_init(&g_slot[index].convert, g_slot[index].session.format, g_slot[index].session.gain, true);
+                    packetizer_init(&g_slot[index].packetizer, &g_slot[index].queue, &g_slot[index].convert,
+                                    g_slot[index].session.packet_size, g_slot[index].session.channels, STREAM_SLOT_QUEUE_MAX);
+                    g_slot_attached[index] = 1;
+                    break;
+                case CORE1_CMD_DETACH :
+                    g_slot_attached[index] = 0;
+                    packetizer_flush(&g_slot[index].packetizer);
+                    g_slot_detached[index] = 1;
+                    break;
+                default :
+                    break;
+            }
+        }
+
+        if((cap_frame = g_source->get_frame(&cap_cnt)) == 0)
+            continue;
+
+        //capture frames are sized by the dma buffers, each session packetizer cuts or joins them into its own packets
+        cap_time = g_source->get_frame_time();
+        if(g_capture.oversample > 1)
+        {
+            //8x oversampled adc
+            cap_index = g_source->get_frame_index() / DECIMATOR_FACTOR;
+            dec_cnt = decimator_process(&g_decimator, cap_frame, cap_cnt, dec_out);
+            g_source->release_frame();
+            for(i = 0; i < STREAM_SLOT_MAX; i++)
+            {
+                if(g_slot_attached[i])
+                    packetizer_put(&g_slot[i].packetizer, PACKETIZER_INPUT_PCM16, dec_out, dec_cnt, cap_time, cap_index);
+            }
+            continue;
+        }
+
+        //channels are interleaved, index counts sample groups
+        cap_index = g_source->get_frame_index() / g_capture.channels;
+        if(g_source->type == CAPTURE_SOURCE_TYPE_ADC12)
+            channel_align_process(&g_align, (uint16_t *)cap_frame, cap_cnt);
+        for(i = 0; i < STREAM_SLOT_MAX; i++)
+        {
+            if(!g_slot_attached[i])
+                continue;
+            if(g_source->type == CAPTURE_SOURCE_TYPE_ADC12)
+                packetizer_put(&g_slot[i].packetizer, PACKETIZER_INPUT_ADC12, cap_frame, cap_cnt, cap_time, cap_index);
+            else
+                packetizer_put(&g_slot[i].packetizer, PACKETIZER_INPUT_S32, cap_frame, cap_cnt, cap_time, cap_index);
+        }
+        g_source->release_frame();
+    }
+}
+
+/* Stream sessions */
+static int8_t stream_slot_find(const uint8_t *owner, uint8_t alloc)
+{
+    int8_t i;
+
+    //a host keeps its slot, and its options, across streams
+    for(i = 0; i < STREAM_SLOT_MAX; i++)
+    {
+        if(memcmp(g_slot[i].owner, owner, 4) == 0)
+            return i;
+    }
+
+    //otherwise take a stopped slot back to the defaults
+    for(i = 0; alloc && (i < STREAM_SLOT_MAX); i++)
+    {
+        if(g_slot[i].status == SEND_STATUS_STOP)
+        {
+            memcpy(g_slot[i].owner, owner, 4);
+            stream_session_default(&g_slot[i].session);
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static uint8_t stream_slot_running(int8_t except)
+{
+    uint8_t count = 0;
+    int8_t i;
+
+    for(i = 0; i < STREAM_SLOT_MAX; i++)
+    {
+        if((i != except) && (g_slot[i].status != SEND_STATUS_STOP))
+            count++;
+    }
+
+    return count;
+}
+
+static int8_t stream_slot_check(int8_t index, const stream_session_t *session)
+{
+    int8_t i;
+    uint8_t nack_count;
+
+    //the capture is shared, later sessions take it as it is
+    if(stream_slot_running(index) &&
+       ((session->source != g_capture.source) || (session->actual_rate != g_capture.actual_rate) ||
+        (session->channels != g_capture.channels) || (session->oversample != g_capture.oversample)))
+    {
+        printf("capture busy, %d x %d ch from %d \r\n", g_capture.actual_rate, g_capture.channels, g_capture.source);
+        return -1;
+    }
+
+    //one RTP stream state and one RTCP socket, one multicast socket, retransmission history for STREAM_SLOT_NACK_MAX
+    for(i = 0, nack_count = 0; i < STREAM_SLOT_MAX; i++)
+    {
+        if((i == index) || (g_slot[i].status == SEND_STATUS_STOP))
+            continue;
+        if((session->protocol == STREAM_SESSION_PROTO_RTP) && (g_slot[i].session.protocol == STREAM_SESSION_PROTO_RTP))
+        {
+            printf("rtp busy \r\n");
+            return -1;
+        }
+        if((session->dest == STREAM_SESSION_DEST_MCAST) && (g_slot[i].session.dest == STREAM_SESSION_DEST_MCAST))
+        {
+            printf("multicast busy \r\n");
+            return -1;
+        }
+        if(session->nack && g_slot[i].session.nack && (++nack_count >= STREAM_SLOT_NACK_MAX))
+        {
+            printf("nack busy \r\n");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int8_t stream_slot_start(int8_t index)
+{
+    stream_slot_t *slot = &g_slot[index];
+
+    stream_session_print(&slot->session);
+    fec_init(&slot->fec, slot->session.fec);
+    retx_clear(&slot->retx);
+    retx_init(&slot->retx, slot->session.actual_rate, slot->session.frame_samples);
+    if(stream_session_begin(&slot->session) != 0)
+    {
+        printf("RTP init failed \r\n");
+        return -1;
+    }
+    if(stream_dest_open(&slot->dest, &slot->session, UDP_SOCKET, MCAST_SOCKET, slot->owner) != 0)
+    {
+        printf("multicast socket failed \r\n");
+        return -1;
+    }
+    if(slot->session.protocol == STREAM_SESSION_PROTO_RTP)
+    {
+        memset(&g_rtcp.report, 0, sizeof(g_rtcp.report));
+        if(rtcp_init(&g_rtcp, RTCP_SOCKET, slot->dest.report_ip, slot->session.port, slot->session.actual_rate, g_rtcp_cname) != 0)
+        {
+            printf("RTCP socket failed \r\n");
+            stream_dest_close(&slot->dest);
+            return -1;
+        }
+        g_rtcp_slot = index;
+    }
+
+    //UDP_ret = sendto(UDP_SOCKET, "START", 5, UDP_BroadIP, UDP_SPORT);
+    slot->send_count = 0;
+    slot->send_index = 0;
+    slot->attended = 0;
+    wiz_get_spi_stat(&slot->spi_start);
+    multicore_fifo_push_blocking(CORE1_CMD_ATTACH | (index << CORE1_CMD_SLOT_SHIFT));
+    //the first session sets up the capture for all
+    if(!stream_slot_running(index))
+    {
+        memcpy(&g_capture, &slot->session, sizeof(stream_session_t));
+        multicore_fifo_push_blocking(CORE1_CMD_START);
+    }
+    slot->status = SEND_STATUS_RUN;
+
+    return 0;
+}
+
+static void stream_slot_stop(int8_t index)
+{
+    stream_slot_t *slot = &g_slot[index];
+    frame_t *frame;
+
+    if(slot->status == SEND_STATUS_STOP)
+        return;
+
+    if(index == g_rtcp_slot)
+    {
+        rtcp_close(&g_rtcp);
+        g_rtcp_slot = -1;
+    }
+    //frames go back to the pool once the SPI DMA is done with the last one
+    wizchip_spi_wait();
+    retx_clear(&slot->retx);
+    stream_dest_close(&slot->dest);
+    frame_pool_give(slot->sent_frame);
+    slot->sent_frame = 0;
+    slot->status = SEND_STATUS_STOP;
+    //the last session stops the capture, the packetizer flush goes after it
+    if(!stream_slot_running(index))
+        multicore_fifo_push_blocking(CORE1_CMD_STOP);
+    g_slot_detached[index] = 0;
+    multicore_fifo_push_blocking(CORE1_CMD_DETACH | (index << CORE1_CMD_SLOT_SHIFT));
+    //frames of this session, the flushed partial one included, must not go out under the next session's header
+    while(!g_slot_detached[index])
+        tight_loop_contents();
+    while((frame = frame_queue_pop(&slot->queue)) != 0)
+        frame_pool_give(frame);
+}
+
+static void stream_slot_send(int8_t index)
+{
+    stream_slot_t *slot = &g_slot[index];
+    frame_t *mic_frame;
+    uint8_t *send_data;
+    uint16_t send_len;
+    uint8_t *fec_data;
+    uint16_t fec_len;
+    wiz_SPIStat spi_stat;
+
+    if((mic_frame = frame_queue_pop(&slot->queue)) != 0)
+    {
+        //the previous frame goes back to the pool once the SPI DMA has read it
+        if(slot->sent_frame)
+        {
+            wizchip_spi_wait();
+            frame_pool_give(slot->sent_frame);
+            slot->sent_frame = 0;
+        }
+
+        //frames queued while paused are discarded, stop drains the queue
+        if(slot->status == SEND_STATUS_RUN)
+        {
+            slot->send_count++;
+            slot->send_index = mic_frame->sample_index;
+            send_data = stream_session_put_header(&slot->session, mic_frame, slot->send_count == 1, &send_len);
+            //the header sits in the headroom right in front of the samples, one piece DMA'd into the chip as it is
+            stream_dest_send(&slot->dest, send_data, send_len);
+            if(slot->session.fec && ((fec_len = fec_add(&slot->fec, send_data, send_len, mic_frame->sample_index, &fec_data)) != 0))
+                stream_dest_send(&slot->dest, fec_data, fec_len);
+            if(index == g_rtcp_slot)
+                rtcp_sent(&g_rtcp, mic_frame->sync_index, mic_frame->timestamp_us, mic_frame->len);
+            if(slot->session.nack)
+            {
+                //kept for retransmission, the oldest kept frame goes back to the pool
+                retx_keep(&slot->retx, mic_frame, send_data, send_len);
+            }
+            else
+            {
+                //sendto_async() may return while the frame is still read by the SPI DMA
+                slot->sent_frame = mic_frame;
+            }
+            mic_frame = 0;
+        }
+        frame_pool_give(mic_frame);
+    }
+
+    if((slot->status == SEND_STATUS_RUN) && (slot->session.packet_limit != 0) && (slot->send_count >= slot->session.packet_limit))
+    {
+        //an RTP receiver would take the marker for a payload
+        if(slot->session.protocol == STREAM_SESSION_PROTO_RAW)
+            stream_dest_send(&slot->dest, (uint8_t *)"STOP", 5);
+        printf("send finish %d : %lu, overrun %d, drop %lu, adc err %lu, pool high-water %d/%d\r\n", index, slot->send_count, g_source->get_overrun(),
+               slot->packetizer.drop, slot->convert.err_count, frame_pool_get_high_water(), FRAME_POOL_FRAME_COUNT);
+        if(slot->session.nack)
+            printf("nack requests %lu, resent %lu, missed %lu\r\n", slot->retx.request, slot->retx.resent, slot->retx.miss);
+        //all chip traffic while the stream ran, other sessions and the control connection included
+        wiz_get_spi_stat(&spi_stat);
+        printf("spi frames %lu, %lu per packet\r\n", spi_stat.frames - slot->spi_start.frames,
+               (spi_stat.frames - slot->spi_start.frames) / slot->send_count);
+        stream_slot_stop(index);
+    }
+}
+
+static stream_slot_t *stream_slot_find_nack(const uint8_t *ip)
+{
+    int8_t i;
+    uint8_t j;
+
+    //the session sending to that host, else any broadcast or multicast one
+    for(i = 0; i < STREAM_SLOT_MAX; i++)
+    {
+        if((g_slot[i].status == SEND_STATUS_STOP) || !g_slot[i].session.nack)
+            continue;
+        if(memcmp(g_slot[i].owner, ip, 4) == 0)
+            return &g_slot[i];
+        for(j = 0; j < g_slot[i].dest.count; j++)
+        {
+            if(memcmp(g_slot[i].dest.ip[j], ip, 4) == 0)
+                return &g_slot[i];
+        }
+    }
+
+    for(i = 0; i < STREAM_SLOT_MAX; i++)
+    {
+        if((g_slot[i].status != SEND_STATUS_STOP) && g_slot[i].session.nack &&
+           ((g_slot[i].session.dest == STREAM_SESSION_DEST_BCAST) || (g_slot[i].session.dest == STREAM_SESSION_DEST_MCAST)))
+            return &g_slot[i];
+    }
+
+    return 0;
+}
+
 uint16_t TCP_Server(uint8_t sn, uint16_t port)
 {
    int32_t ret;
@@ -391,6 +917,9 @@ uint16_t TCP_Server(uint8_t sn, uint16_t port)
             #endif
 	  	   return 17;
          break;
+      case SOCK_LISTEN :
+         //nothing to do until the CON interrupt
+         return SOCK_LISTEN;
       case SOCK_CLOSE_WAIT :
 #ifdef TCP_S_DEBUG_
          printf("%d:CloseWait\r\n",sn);
@@ -410,7 +939,8 @@ uint16_t TCP_Server(uint8_t sn, uint16_t port)
 #ifdef TCP_S_DEBUG_
          //printf("%d:TCP server loopback start\r\n",sn);
 #endif
-         if((ret = socket(sn, Sn_MR_TCP, port, 0x00)) != sn) return ret;
+         //nonblocking so a heartbeat to a vanished host never stalls streaming
+         if((ret = socket(sn, Sn_MR_TCP, port, SF_IO_NONBLOCK)) != sn) return ret;
 #ifdef TCP_S_DEBUG_
          printf("%d:Socket opened\r\n",sn);
 #endif
@@ -453,7 +983,7 @@ uint8_t *TCP_S_Recv(uint8_t sn, uint16_t *rcv_size)
    {
        if(size > DATA_BUF_SIZE) size = DATA_BUF_SIZE;
        printf("recv Data size : %d \r\n", size);
-       buff = (uint8_t *)calloc(size, sizeof(uint8_t));
+       buff = (uint8_t *)calloc(size + 1, sizeof(uint8_t)); // keep a terminating null for command parsing
        if(buff == 0)
        {
             printf("calloc error \r\n");
@@ -571,6 +1101,7 @@ int32_t udps_status(uint8_t sn, uint8_t* buf, uint16_t port)
    uint16_t size, sentsize;
    uint8_t  destip[4];
    uint16_t destport;
+   stream_slot_t *slot;
 
    switch(getSn_SR(sn))
    {
@@ -587,6 +1118,13 @@ int32_t udps_status(uint8_t sn, uint8_t* buf, uint16_t port)
                return ret;
             }
             size = (uint16_t) ret;
+            //retransmission requests from the stream receivers, anything else is echoed
+            if(retx_is_nack(buf, size))
+            {
+               if((slot = stream_slot_find_nack(destip)) != 0)
+                  retx_process(&slot->retx, sn, buf, size, destip, destport);
+               return SOCK_UDP;
+            }
             sentsize = 0;
             while(sentsize != size)
             {
@@ -41,32 +41,75 @@
 #include "w5100s.h"
 
 #if   (_WIZCHIP_ == W5100S)
+// Access counters, one frame per chip select, see wiz_get_spi_stat()
+static wiz_SPIStat wiz_spi_stat;
+#define WIZCHIP_STAT_ADD(len)   { wiz_spi_stat.frames++; wiz_spi_stat.bytes += (len); }
+
+// TX/RX buffer layout of each socket, only changes with TMSR/RMSR, see wiz_sock_mem_load()
+typedef struct wiz_SockMem_t
+{
+   uint32_t txbase;
+   uint32_t rxbase;
+   uint16_t txmax;
+   uint16_t rxmax;
+}wiz_SockMem;
+
+static wiz_SockMem wiz_sock_mem[_WIZCHIP_SOCK_NUM_];
+static uint8_t wiz_sock_mem_valid = 0;
+
+#if( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_) )
+// One transaction through the frame callback, which selects and deselects the chip itself
+static void wiz_spi_frame(uint8_t op, uint32_t AddrSel, wiz_IOVec* vec, uint8_t cnt, uint8_t* rx, uint16_t rxlen)
+{
+   wiz_IOVec frame[WIZ_IOVEC_MAX + 2];
+   uint8_t spi_data[3];
+   uint8_t i;
+
+   spi_data[0] = op;
+   spi_data[1] = (((uint16_t)AddrSel) & 0xFF00) >>  8;
+   spi_data[2] = (((uint16_t)AddrSel) & 0x00FF) >>  0;
+   frame[0].buf = spi_data;
+   frame[0].len = 3;
+   for(i = 0; i < cnt; i++) frame[i + 1] = vec[i];
+
+   WIZCHIP_CRITICAL_ENTER();
+   WIZCHIP_STAT_ADD(rxlen);
+   for(i = 0; i < cnt; i++) wiz_spi_stat.bytes += vec[i].len;
+   WIZCHIP.IF.SPI._frame(frame, cnt + 1, rx, rxlen);
+   WIZCHIP_CRITICAL_EXIT();
+}
+#endif
+
 /**
 @brief  This function writes the data into W5100S registers.
 */
 void     WIZCHIP_WRITE(uint32_t AddrSel, uint8_t wb )
 {
+#if( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_5500_) )
    uint8_t spi_data[4];
+#endif
+#if( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_) )
+   wiz_IOVec vec;
+
+   if(WIZCHIP.IF.SPI._frame)
+   {
+      vec.buf = &wb;
+      vec.len = 1;
+      wiz_spi_frame(0xF0, AddrSel, &vec, 1, 0, 0);
+      return;
+   }
+#endif
 
    WIZCHIP_CRITICAL_ENTER();
    WIZCHIP.CS._select();
+   WIZCHIP_STAT_ADD(1);
 
 #if( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_))
-   if(!WIZCHIP.IF.SPI._write_burst) 	// byte operation
-   {
-      WIZCHIP.IF.SPI._write_byte(0xF0);
-      WIZCHIP.IF.SPI._write_byte((AddrSel & 0xFF00) >>  8);
-      WIZCHIP.IF.SPI._write_byte((AddrSel & 0x00FF) >>  0);
-      WIZCHIP.IF.SPI._write_byte(wb);    // Data write (write 1byte data)
-   }
-   else     // burst operation
-   {
-      spi_data[0] = 0xF0;
-		spi_data[1] = (AddrSel & 0xFF00) >>  8;
-		spi_data[2] = (AddrSel & 0x00FF) >>  0;
-		spi_data[3] = wb;
-		WIZCHIP.IF.SPI._write_burst(spi_data, 4);
-   }
+   // A register always goes byte by byte, a burst costs more to set up than 4 bytes
+   WIZCHIP.IF.SPI._write_byte(0xF0);
+   WIZCHIP.IF.SPI._write_byte((AddrSel & 0xFF00) >>  8);
+   WIZCHIP.IF.SPI._write_byte((AddrSel & 0x00FF) >>  0);
+   WIZCHIP.IF.SPI._write_byte(wb);    // Data write (write 1byte data)
 #elif ( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_5500_) )
    if(!WIZCHIP.IF.SPI._write_burst) 	// byte operation
    {
@@ -107,24 +150,25 @@ void     WIZCHIP_WRITE(uint32_t AddrSel, uint8_t wb )
 uint8_t  WIZCHIP_READ(uint32_t AddrSel)
 {
    uint8_t ret;
+#if( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_5500_) )
    uint8_t spi_data[3];
+#endif
+#if( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_) )
+   if(WIZCHIP.IF.SPI._frame)
+   {
+      wiz_spi_frame(0x0F, AddrSel, 0, 0, &ret, 1);
+      return ret;
+   }
+#endif
    WIZCHIP_CRITICAL_ENTER();
    WIZCHIP.CS._select();
+   WIZCHIP_STAT_ADD(1);
 
 #if( (_WIZCHIP_IO_MODE_ ==  _WIZCHIP_IO_MODE_SPI_))
-   if(!WIZCHIP.IF.SPI._read_burst || !WIZCHIP.IF.SPI._write_burst) 	// byte operation
-   {
-        WIZCHIP.IF.SPI._write_byte(0x0F);
-        WIZCHIP.IF.SPI._write_byte((AddrSel & 0xFF00) >>  8);
-        WIZCHIP.IF.SPI._write_byte((AddrSel & 0x00FF) >>  0);
-   }
-   else
-   {
-        spi_data[0] = 0x0F;
-        spi_data[1] = (AddrSel & 0xFF00) >>  8;
-        spi_data[2] = (AddrSel & 0x00FF) >>  0;
-        WIZCHIP.IF.SPI._write_burst(spi_data, 3);
-   }
+   // A register always goes byte by byte, a burst costs more to set up than 4 bytes
+   WIZCHIP.IF.SPI._write_byte(0x0F);
+   WIZCHIP.IF.SPI._write_byte((AddrSel & 0xFF00) >>  8);
+   WIZCHIP.IF.SPI._write_byte((AddrSel & 0x00FF) >>  0);
    ret = WIZCHIP.IF.SPI._read_byte(); 
 #elif ( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_5500_) )
    if(!WIZCHIP.IF.SPI._read_burst || !WIZCHIP.IF.SPI._write_burst) 	// burst operation
@@ -169,13 +213,34 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len)
 {
    uint8_t spi_data[3];
    uint16_t i = 0;
+#if( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_) )
+   wiz_IOVec vec;
+
+   if(WIZCHIP.IF.SPI._frame)
+   {
+      vec.buf = pBuf;
+      vec.len = len;
+      wiz_spi_frame(0xF0, AddrSel, &vec, 1, 0, 0);
+      return;
+   }
+
+   // Command and data chained in one burst
+   if(WIZCHIP.IF.SPI._write_burst_vec && (len >= _WIZCHIP_SPI_BURST_MIN_))
+   {
+      vec.buf = pBuf;
+      vec.len = len;
+      WIZCHIP_WRITE_BUF_VEC(AddrSel, &vec, 1);
+      return;
+   }
+#endif
 
    WIZCHIP_CRITICAL_ENTER();
    WIZCHIP.CS._select();   //M20150601 : Moved here.
+   WIZCHIP_STAT_ADD(len);
 
 #if((_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_))
 
-   if(!WIZCHIP.IF.SPI._write_burst) 	// byte operation
+   if(!WIZCHIP.IF.SPI._write_burst || (len < _WIZCHIP_SPI_BURST_MIN_)) 	// byte operation
    {
       WIZCHIP.IF.SPI._write_byte(0xF0);
       WIZCHIP.IF.SPI._write_byte((((uint16_t)(AddrSel+i)) & 0xFF00) >>  8);
@@ -240,24 +305,110 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len)
    WIZCHIP_CRITICAL_EXIT();
 }
 
+/**
+@brief  This function writes pieces into W5100S memory(Buffer) back to back
+*/
+void     WIZCHIP_WRITE_BUF_VEC(uint32_t AddrSel, wiz_IOVec* vec, uint8_t cnt)
+{
+   wiz_IOVec frame[WIZ_IOVEC_MAX + 2];
+   uint8_t spi_data[3];
+   uint8_t i;
+
+#if( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_) )
+   if(WIZCHIP.IF.SPI._frame && (cnt < WIZ_IOVEC_MAX + 2))
+   {
+      wiz_spi_frame(0xF0, AddrSel, vec, cnt, 0, 0);
+      return;
+   }
+
+   if(WIZCHIP.IF.SPI._write_burst_vec && (cnt < WIZ_IOVEC_MAX + 2))
+   {
+      // One SPI frame, the address auto-increments over the pieces
+      spi_data[0] = 0xF0;
+      spi_data[1] = (((uint16_t)AddrSel) & 0xFF00) >>  8;
+      spi_data[2] = (((uint16_t)AddrSel) & 0x00FF) >>  0;
+      frame[0].buf = spi_data;
+      frame[0].len = 3;
+      for(i = 0; i < cnt; i++) frame[i + 1] = vec[i];
+
+      WIZCHIP_CRITICAL_ENTER();
+      WIZCHIP.CS._select();
+      WIZCHIP_STAT_ADD(0);
+      for(i = 0; i < cnt; i++) wiz_spi_stat.bytes += vec[i].len;
+      WIZCHIP.IF.SPI._write_burst_vec(frame, cnt + 1);
+      WIZCHIP.CS._deselect();
+      WIZCHIP_CRITICAL_EXIT();
+      return;
+   }
+#endif
+
+   for(i = 0; i < cnt; i++)
+   {
+      WIZCHIP_WRITE_BUF(AddrSel, vec[i].buf, vec[i].len);
+      AddrSel += vec[i].len;
+   }
+}
+
+/**
+@brief  Same as WIZCHIP_WRITE_BUF_VEC(), but returns while the data is still being written when an asynchronous burst is registered
+*/
+void     WIZCHIP_WRITE_BUF_VEC_ASYNC(uint32_t AddrSel, wiz_IOVec* vec, uint8_t cnt)
+{
+#if( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_) )
+   static uint8_t spi_data[3];   // read by the transfer after return, free again once the next access has entered
+   wiz_IOVec frame[WIZ_IOVEC_MAX + 2];
+   uint8_t i;
+
+   if(WIZCHIP.IF.SPI._write_burst_vec_async && (cnt < WIZ_IOVEC_MAX + 2))
+   {
+      WIZCHIP_CRITICAL_ENTER();   // waits for the previous asynchronous burst
+      WIZCHIP_STAT_ADD(0);
+      for(i = 0; i < cnt; i++) wiz_spi_stat.bytes += vec[i].len;
+      spi_data[0] = 0xF0;
+      spi_data[1] = (((uint16_t)AddrSel) & 0xFF00) >>  8;
+      spi_data[2] = (((uint16_t)AddrSel) & 0x00FF) >>  0;
+      frame[0].buf = spi_data;
+      frame[0].len = 3;
+      for(i = 0; i < cnt; i++) frame[i + 1] = vec[i];
+
+      if(!WIZCHIP.IF.SPI._frame) WIZCHIP.CS._select();   // a framing interface selects the chip itself
+      WIZCHIP.IF.SPI._write_burst_vec_async(frame, cnt + 1);   // the port deselects when done
+      WIZCHIP_CRITICAL_EXIT();
+      return;
+   }
+#endif
+
+   WIZCHIP_WRITE_BUF_VEC(AddrSel, vec, cnt);
+}
+
 /**
 @brief  This function reads into W5100S memory(Buffer)
 */ 
 
 void     WIZCHIP_READ_BUF (uint32_t AddrSel, uint8_t* pBuf, uint16_t len)
 {
+#if( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_5500_) )
    uint8_t spi_data[3];
+#endif
    uint16_t i = 0;
+#if( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_) )
+   if(WIZCHIP.IF.SPI._frame)
+   {
+      wiz_spi_frame(0x0F, AddrSel, 0, 0, pBuf, len);
+      return;
+   }
+#endif
    WIZCHIP_CRITICAL_ENTER();
    WIZCHIP.CS._select();   //M20150601 : Moved here.
+   WIZCHIP_STAT_ADD(len);
    
 #if( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_) )
-   if(!WIZCHIP.IF.SPI._read_burst || !WIZCHIP.IF.SPI._write_burst) 	// byte operation
+   // The 3 command bytes go byte by byte, only the data is worth a burst
+   WIZCHIP.IF.SPI._write_byte(0x0F);
+   WIZCHIP.IF.SPI._write_byte((uint16_t)((AddrSel+i) & 0xFF00) >>  8);
+   WIZCHIP.IF.SPI._write_byte((uint16_t)((AddrSel+i) & 0x00FF) >>  0);
+   if(!WIZCHIP.IF.SPI._read_burst || (len < _WIZCHIP_SPI_BURST_MIN_)) 	// byte operation
    {
-      WIZCHIP.IF.SPI._write_byte(0x0F);
-      WIZCHIP.IF.SPI._write_byte((uint16_t)((AddrSel+i) & 0xFF00) >>  8);
-      WIZCHIP.IF.SPI._write_byte((uint16_t)((AddrSel+i) & 0x00FF) >>  0);
-
       for(i = 0; i < len; i++)
       {
          pBuf[i] = WIZCHIP.IF.SPI._read_byte(); 
@@ -265,12 +416,7 @@ void     WIZCHIP_READ_BUF (uint32_t AddrSel, uint8_t* pBuf, uint16_t len)
    }           
    else																// burst operation
    {
-		spi_data[0] = 0x0F;
-		spi_data[1] = (uint16_t)((AddrSel+i) & 0xFF00) >>  8;
-		spi_data[2] = (uint16_t)((AddrSel+i) & 0x00FF) >>  0;
-		WIZCHIP.IF.SPI._write_burst(spi_data, 3);
 		WIZCHIP.IF.SPI._read_burst(pBuf, len);
-
    }
 #elif ( (_WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_SPI_5500_) )
    if(!WIZCHIP.IF.SPI._read_burst || !WIZCHIP.IF.SPI._write_burst) 	// byte operation
@@ -319,6 +465,40 @@ void     WIZCHIP_READ_BUF (uint32_t AddrSel, uint8_t* pBuf, uint16_t len)
    WIZCHIP_CRITICAL_EXIT();
 }
 
+/**
+@brief  This function reads a 16 bit W5100S register in one access.
+*/
+uint16_t WIZCHIP_READ_WORD(uint32_t AddrSel)
+{
+   uint8_t buf[2];
+
+   WIZCHIP_READ_BUF(AddrSel, buf, 2);
+   return ((uint16_t)buf[0] << 8) + buf[1];
+}
+
+/**
+@brief  This function writes a 16 bit W5100S register in one access.
+*/
+void     WIZCHIP_WRITE_WORD(uint32_t AddrSel, uint16_t wb)
+{
+   uint8_t buf[2];
+
+   buf[0] = (uint8_t)(wb >> 8);
+   buf[1] = (uint8_t)wb;
+   WIZCHIP_WRITE_BUF(AddrSel, buf, 2);
+}
+
+void     wiz_get_spi_stat(wiz_SPIStat* stat)
+{
+   *stat = wiz_spi_stat;
+}
+
+void     wiz_clear_spi_stat(void)
+{
+   wiz_spi_stat.frames = 0;
+   wiz_spi_stat.bytes = 0;
+}
+
 ///////////////////////////////////
 // Socket N regsiter IO function //
 ///////////////////////////////////
@@ -326,14 +506,13 @@ void     WIZCHIP_READ_BUF (uint32_t AddrSel, uint8_t* pBuf, uint16_t len)
 uint16_t getSn_TX_FSR(uint8_t sn)
 {
    uint16_t val=0,val1=0;
+   // Each read takes both bytes in one frame, still read twice as the chip may update it in between
    do
    {
-      val1 = WIZCHIP_READ(Sn_TX_FSR(sn));
-      val1 = (val1 << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_TX_FSR(sn),1));
+      val1 = WIZCHIP_READ_WORD(Sn_TX_FSR(sn));
       if (val1 != 0)
       {
-        val = WIZCHIP_READ(Sn_TX_FSR(sn));
-        val = (val << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_TX_FSR(sn),1));
+        val = WIZCHIP_READ_WORD(Sn_TX_FSR(sn));
       }
    }while (val != val1);
    return val;
@@ -345,12 +524,10 @@ uint16_t getSn_RX_RSR(uint8_t sn)
    uint16_t val=0,val1=0;
    do
    {
-      val1 = WIZCHIP_READ(Sn_RX_RSR(sn));
-      val1 = (val1 << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_RX_RSR(sn),1));
+      val1 = WIZCHIP_READ_WORD(Sn_RX_RSR(sn));
       if (val1 != 0)
       {
-        val = WIZCHIP_READ(Sn_RX_RSR(sn));
-        val = (val << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_RX_RSR(sn),1));
+        val = WIZCHIP_READ_WORD(Sn_RX_RSR(sn));
       }
    }while (val != val1);
    return val;
@@ -359,31 +536,60 @@ uint16_t getSn_RX_RSR(uint8_t sn)
 /////////////////////////////////////
 // Sn_TXBUF & Sn_RXBUF IO function //
 /////////////////////////////////////
-uint32_t getSn_RxBASE(uint8_t sn)
+void wiz_sock_mem_load(void)
 {
    int8_t  i;
+   uint8_t tmsr, rmsr;
 #if ( _WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_BUS_DIR_)
+   uint32_t txbase = _W5100S_IO_BASE_ + _WIZCHIP_IO_TXBUF_;
    uint32_t rxbase = _W5100S_IO_BASE_ + _WIZCHIP_IO_RXBUF_;
 #else   
+   uint32_t txbase = _WIZCHIP_IO_TXBUF_;
    uint32_t rxbase = _WIZCHIP_IO_RXBUF_;
 #endif   
-   for(i = 0; i < sn; i++)
-      rxbase += getSn_RxMAX(i);
 
-   return rxbase;
+   // Two reads for the whole layout, instead of some per socket on every send and receive
+   tmsr = WIZCHIP_READ(TMSR);
+   rmsr = WIZCHIP_READ(RMSR);
+   for(i = 0; i < _WIZCHIP_SOCK_NUM_; i++)
+   {
+      wiz_sock_mem[i].txmax = (uint16_t)(0x0001 << ((tmsr >> (2*i)) & 0x03)) << 10;
+      wiz_sock_mem[i].rxmax = (uint16_t)(0x0001 << ((rmsr >> (2*i)) & 0x03)) << 10;
+      wiz_sock_mem[i].txbase = txbase;
+      wiz_sock_mem[i].rxbase = rxbase;
+      txbase += wiz_sock_mem[i].txmax;
+      rxbase += wiz_sock_mem[i].rxmax;
+   }
+   wiz_sock_mem_valid = 1;
+}
+
+void wiz_sock_mem_clear(void)
+{
+   wiz_sock_mem_valid = 0;
+}
+
+uint16_t getSn_RxMAX(uint8_t sn)
+{
+   if(!wiz_sock_mem_valid) wiz_sock_mem_load();
+   return wiz_sock_mem[sn].rxmax;
+}
+
+uint16_t getSn_TxMAX(uint8_t sn)
+{
+   if(!wiz_sock_mem_valid) wiz_sock_mem_load();
+   return wiz_sock_mem[sn].txmax;
+}
+
+uint32_t getSn_RxBASE(uint8_t sn)
+{
+   if(!wiz_sock_mem_valid) wiz_sock_mem_load();
+   return wiz_sock_mem[sn].rxbase;
 }
 
 uint32_t getSn_TxBASE(uint8_t sn)
 {
-   int8_t  i;
-#if ( _WIZCHIP_IO_MODE_ == _WIZCHIP_IO_MODE_BUS_DIR_)
-   uint32_t txbase = _W5100S_IO_BASE_ + _WIZCHIP_IO_TXBUF_;
-#else   
-   uint32_t txbase = _WIZCHIP_IO_TXBUF_;
-#endif   
-   for(i = 0; i < sn; i++)
-      txbase += getSn_TxMAX(i);
-   return txbase;
+   if(!wiz_sock_mem_valid) wiz_sock_mem_load();
+   return wiz_sock_mem[sn].txbase;
 }
 
 /**
@@ -429,6 +635,69 @@ void wiz_send_data(uint8_t sn, uint8_t *wizdata, uint16_t len)
 }
 
 
+/**
+@brief  Writes pieces into the TX buffer of the socket from ptr on, without moving Sn_TX_WR.
+
+The pieces are split where the TX ring wraps and each side goes out as one SPI frame.
+*/
+uint16_t wiz_put_data_vec(uint8_t sn, uint16_t ptr, wiz_IOVec *vec, uint8_t cnt)
+{
+  wiz_IOVec head[WIZ_IOVEC_MAX + 1];
+  wiz_IOVec tail[WIZ_IOVEC_MAX + 1];
+  uint8_t head_cnt = 0;
+  uint8_t tail_cnt = 0;
+  uint16_t len = 0;
+  uint16_t room;
+  uint16_t dst_mask;
+  uint8_t i;
+
+  if(cnt > WIZ_IOVEC_MAX) cnt = WIZ_IOVEC_MAX;
+
+  dst_mask = ptr & getSn_TxMASK(sn);
+  room = getSn_TxMAX(sn) - dst_mask;
+
+  // Split the pieces where the TX ring wraps, at most one piece is cut in two
+  for(i = 0; i < cnt; i++)
+  {
+    if(vec[i].len == 0) continue;
+    if(len >= room)
+    {
+      tail[tail_cnt++] = vec[i];
+    }
+    else if(len + vec[i].len > room)
+    {
+      head[head_cnt].buf = vec[i].buf;
+      head[head_cnt++].len = room - len;
+      tail[tail_cnt].buf = vec[i].buf + (room - len);
+      tail[tail_cnt++].len = vec[i].len - (room - len);
+    }
+    else
+    {
+      head[head_cnt++] = vec[i];
+    }
+    len += vec[i].len;
+  }
+
+  // May return while the data is still going out, the next access waits for it
+  if(head_cnt) WIZCHIP_WRITE_BUF_VEC_ASYNC(getSn_TxBASE(sn) + dst_mask, head, head_cnt);
+  if(tail_cnt) WIZCHIP_WRITE_BUF_VEC_ASYNC(getSn_TxBASE(sn), tail, tail_cnt);
+
+  return len;
+}
+
+/**
+@brief  Same as wiz_send_data() for a datagram in several pieces.
+*/
+void wiz_send_data_vec(uint8_t sn, wiz_IOVec *vec, uint8_t cnt)
+{
+  uint16_t ptr;
+
+  ptr = getSn_TX_WR(sn);
+  ptr += wiz_put_data_vec(sn, ptr, vec, cnt);
+
+  setSn_TX_WR(sn, ptr);
+}
+
 /**
 @brief  This function is being called by recv() also. This function is being used for copy the data form Receive buffer of the chip to application buffer.
 
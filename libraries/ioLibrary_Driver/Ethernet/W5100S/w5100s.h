@@ -1803,6 +1803,22 @@ uint8_t  WIZCHIP_READ (uint32_t AddrSel);
  */
 void     WIZCHIP_WRITE(uint32_t AddrSel, uint8_t wb );
 
+/**
+ * @ingroup Basic_IO_function_W5100S
+ * @brief It reads a 16 bit register, upper byte first, in one access.
+ * @param AddrSel Address of the upper byte
+ * @return The value of register
+ */
+uint16_t WIZCHIP_READ_WORD(uint32_t AddrSel);
+
+/**
+ * @ingroup Basic_IO_function_W5100S
+ * @brief It writes a 16 bit register, upper byte first, in one access.
+ * @param AddrSel Address of the upper byte
+ * @param wb Write data
+ */
+void     WIZCHIP_WRITE_WORD(uint32_t AddrSel, uint16_t wb);
+
 /**
  * @ingroup Basic_IO_function_W5100S
  * @brief It reads sequence data from registers.
@@ -1821,6 +1837,52 @@ void     WIZCHIP_READ_BUF (uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
  */
 void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
 
+/**
+ * @ingroup Basic_IO_function_W5100S
+ * @brief It writes pieces of data to registers back to back, in one SPI frame when a gathered burst is registered.
+ * @param AddrSel Register address of the first byte
+ * @param vec Pieces to write
+ * @param cnt Number of pieces
+ * @sa reg_wizchip_spiburst_vec_cbfunc()
+ */
+void     WIZCHIP_WRITE_BUF_VEC(uint32_t AddrSel, wiz_IOVec* vec, uint8_t cnt);
+
+/**
+ * @ingroup Basic_IO_function_W5100S
+ * @brief Same as WIZCHIP_WRITE_BUF_VEC(), but may return while the data is still being written.
+ * @details With an asynchronous burst registered the transfer runs in the background and the next
+ * register access waits for it. The pieces themselves must stay unchanged until then, the piece list may be reused at once.
+ * Without one it is WIZCHIP_WRITE_BUF_VEC().
+ * @param AddrSel Register address of the first byte
+ * @param vec Pieces to write
+ * @param cnt Number of pieces
+ * @sa reg_wizchip_spiburst_async_cbfunc()
+ */
+void     WIZCHIP_WRITE_BUF_VEC_ASYNC(uint32_t AddrSel, wiz_IOVec* vec, uint8_t cnt);
+
+/**
+ * @ingroup Basic_IO_function_W5100S
+ * @brief Access counters of the basic I/O functions. Read them before and after a call to see what it costs.
+ */
+typedef struct wiz_SPIStat_t
+{
+   uint32_t frames;   ///< Accesses, each one SPI frame with its own command bytes and chip select
+   uint32_t bytes;    ///< Data bytes moved, command bytes not counted
+}wiz_SPIStat;
+
+/**
+ * @ingroup Basic_IO_function_W5100S
+ * @brief It copies the access counters.
+ * @param stat Counters since the last wiz_clear_spi_stat()
+ */
+void     wiz_get_spi_stat(wiz_SPIStat* stat);
+
+/**
+ * @ingroup Basic_IO_function_W5100S
+ * @brief It clears the access counters.
+ */
+void     wiz_clear_spi_stat(void);
+
 
 /////////////////////////////////
 // Common Register IO function //
@@ -1967,10 +2029,8 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
  * @param (uint16_t)rtr Value to set @ref _RTR_ register.
  * @sa getRTR()
  */
-#define setRTR(rtr)   {\
-		WIZCHIP_WRITE(_RTR_,   (uint8_t)(rtr >> 8)); \
-		WIZCHIP_WRITE(WIZCHIP_OFFSET_INC(_RTR_,1), (uint8_t) rtr); \
-	}
+#define setRTR(rtr)   \
+		WIZCHIP_WRITE_WORD(_RTR_, (uint16_t)(rtr))
 
 /**
  * @ingroup Common_register_access_function_W5100S
@@ -1979,7 +2039,7 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
  * @sa setRTR()
  */
 #define getRTR() \
-		(((uint16_t)WIZCHIP_READ(_RTR_) << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(_RTR_,1)))
+		WIZCHIP_READ_WORD(_RTR_)
 
 /**
  * @ingroup Common_register_access_function_W5100S
@@ -2005,7 +2065,7 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
  * @sa getRMSR()
  */
 #define setRMSR(rmsr)   \
-      WIZCHIP_WRITE(RMSR,rmsr) // Receicve Memory Size
+      (WIZCHIP_WRITE(RMSR,rmsr), wiz_sock_mem_clear()) // Receicve Memory Size
 
 /**
  * @ingroup Common_register_access_function_W5100S
@@ -2022,7 +2082,7 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
  * @sa getTMSR()
  */
 #define setTMSR(tmsr)   \
-      WIZCHIP_WRITE(TMSR,tmsr) // Receicve Memory Size
+      (WIZCHIP_WRITE(TMSR,tmsr), wiz_sock_mem_clear()) // Receicve Memory Size
 
 /**
  * @ingroup Common_register_access_function_W5100S
@@ -2040,7 +2100,7 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
  * @return uint16_t. Value to set \ref PATR register
  */
 #define getPATR() \
-		(((uint16_t)WIZCHIP_READ(PATR) << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(PATR,1)))
+		WIZCHIP_READ_WORD(PATR)
 
 /**
  * @ingroup Common_register_access_function_W5100S
@@ -2764,10 +2824,8 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
  * @param (uint16_t)port Value to set @ref Sn_PORT.
  * @sa getSn_PORT()
  */
-#define setSn_PORT(sn, port)  { \
-		WIZCHIP_WRITE(Sn_PORT(sn),   (uint8_t)(port >> 8)); \
-		WIZCHIP_WRITE(WIZCHIP_OFFSET_INC(Sn_PORT(sn),1), (uint8_t) port); \
-	}
+#define setSn_PORT(sn, port)  \
+		WIZCHIP_WRITE_WORD(Sn_PORT(sn), (uint16_t)(port))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -2777,7 +2835,7 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
  * @sa setSn_PORT()
  */
 #define getSn_PORT(sn) \
-		(((uint16_t)WIZCHIP_READ(Sn_PORT(sn)) << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_PORT(sn),1)))
+		WIZCHIP_READ_WORD(Sn_PORT(sn))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -2826,10 +2884,8 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
  * @param (uint16_t)dport Value to set @ref Sn_DPORT
  * @sa getSn_DPORT()
  */
-#define setSn_DPORT(sn, dport) { \
-		WIZCHIP_WRITE(Sn_DPORT(sn),   (uint8_t) (dport>>8)); \
-		WIZCHIP_WRITE(WIZCHIP_OFFSET_INC(Sn_DPORT(sn),1), (uint8_t)  dport); \
-	}
+#define setSn_DPORT(sn, dport) \
+		WIZCHIP_WRITE_WORD(Sn_DPORT(sn), (uint16_t)(dport))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -2839,7 +2895,7 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
  * @sa setSn_DPORT()
  */
 #define getSn_DPORT(sn) \
-		(((uint16_t)WIZCHIP_READ(Sn_DPORT(sn)) << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_DPORT(sn),1)))
+		WIZCHIP_READ_WORD(Sn_DPORT(sn))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -2848,10 +2904,8 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
  * @param (uint16_t)mss Value to set @ref Sn_MSSR
  * @sa setSn_MSSR()
  */
-#define setSn_MSSR(sn, mss) { \
-		WIZCHIP_WRITE(Sn_MSSR(sn),   (uint8_t)(mss>>8)); \
-		WIZCHIP_WRITE(WIZCHIP_OFFSET_INC(Sn_MSSR(sn),1), (uint8_t) mss); \
-	}
+#define setSn_MSSR(sn, mss) \
+		WIZCHIP_WRITE_WORD(Sn_MSSR(sn), (uint16_t)(mss))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -2861,7 +2915,7 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
  * @sa setSn_MSSR()
  */
 #define getSn_MSSR(sn) \
-		(((uint16_t)WIZCHIP_READ(Sn_MSSR(sn)) << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_MSSR(sn),1)))
+		WIZCHIP_READ_WORD(Sn_MSSR(sn))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -2931,7 +2985,7 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
  * @sa getSn_RXMEM_SIZE()
  */
 #define  setSn_RXMEM_SIZE(sn, rxmemsize) \
-      WIZCHIP_WRITE(RMSR, (WIZCHIP_READ(RMSR) & ~(0x03 << (2*sn))) | (rxmemsize << (2*sn)))
+      (WIZCHIP_WRITE(RMSR, (WIZCHIP_READ(RMSR) & ~(0x03 << (2*sn))) | (rxmemsize << (2*sn))), wiz_sock_mem_clear())
 #define setSn_RXBUF_SIZE(sn,rxmemsize) setSn_RXMEM_SIZE(sn,rxmemsize)
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -2952,7 +3006,7 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
  * @sa getSn_TXMEM_SIZE()
  */
 #define setSn_TXMEM_SIZE(sn, txmemsize) \
-      WIZCHIP_WRITE(TMSR, (WIZCHIP_READ(TMSR) & ~(0x03 << (2*sn))) | (txmemsize << (2*sn)))
+      (WIZCHIP_WRITE(TMSR, (WIZCHIP_READ(TMSR) & ~(0x03 << (2*sn))) | (txmemsize << (2*sn))), wiz_sock_mem_clear())
 #define  setSn_TXBUF_SIZE(sn, txmemsize) setSn_TXMEM_SIZE(sn,txmemsize)
 
 /**
@@ -2981,7 +3035,7 @@ uint16_t getSn_TX_FSR(uint8_t sn);
  * @return uint16_t. Value of @ref Sn_TX_RD.
  */
 #define getSn_TX_RD(sn) \
-		(((uint16_t)WIZCHIP_READ(Sn_TX_RD(sn)) << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_TX_RD(sn),1)))
+		WIZCHIP_READ_WORD(Sn_TX_RD(sn))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -2990,10 +3044,8 @@ uint16_t getSn_TX_FSR(uint8_t sn);
  * @param (uint16_t)txwr Value to set @ref Sn_TX_WR
  * @sa GetSn_TX_WR()
  */
-#define setSn_TX_WR(sn, txwr) { \
-		WIZCHIP_WRITE(Sn_TX_WR(sn),   (uint8_t)(txwr>>8)); \
-		WIZCHIP_WRITE(WIZCHIP_OFFSET_INC(Sn_TX_WR(sn),1), (uint8_t) txwr); \
-		}
+#define setSn_TX_WR(sn, txwr) \
+		WIZCHIP_WRITE_WORD(Sn_TX_WR(sn), (uint16_t)(txwr))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -3003,7 +3055,7 @@ uint16_t getSn_TX_FSR(uint8_t sn);
  * @sa setSn_TX_WR()
  */
 #define getSn_TX_WR(sn) \
-		(((uint16_t)WIZCHIP_READ(Sn_TX_WR(sn)) << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_TX_WR(sn),1)))
+		WIZCHIP_READ_WORD(Sn_TX_WR(sn))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -3020,10 +3072,8 @@ uint16_t getSn_RX_RSR(uint8_t sn);
  * @param (uint16_t)rxrd Value to set @ref Sn_RX_RD
  * @sa getSn_RX_RD()
  */
-#define setSn_RX_RD(sn, rxrd) { \
-		WIZCHIP_WRITE(Sn_RX_RD(sn),   (uint8_t)(rxrd>>8)); \
-		WIZCHIP_WRITE(WIZCHIP_OFFSET_INC(Sn_RX_RD(sn),1), (uint8_t) rxrd); \
-	}
+#define setSn_RX_RD(sn, rxrd) \
+		WIZCHIP_WRITE_WORD(Sn_RX_RD(sn), (uint16_t)(rxrd))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -3033,7 +3083,7 @@ uint16_t getSn_RX_RSR(uint8_t sn);
  * @sa setSn_RX_RD()
  */
 #define getSn_RX_RD(sn) \
-		(((uint16_t)WIZCHIP_READ(Sn_RX_RD(sn)) << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_RX_RD(sn),1)))
+		WIZCHIP_READ_WORD(Sn_RX_RD(sn))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -3042,10 +3092,8 @@ uint16_t getSn_RX_RSR(uint8_t sn);
  * @param (uint16_t)rxwr Value to set \ref Sn_RX_WR
  * @sa getSn_RX_WR()
  */
-#define setSn_RX_WR(sn, rxwr) { \
-		WIZCHIP_WRITE(Sn_RX_WR(sn),   (uint8_t)(rxwr>>8)); \
-	   WIZCHIP_WRITE(WIZCHIP_OFFSET_INC(Sn_RX_WR(sn),1), (uint8_t) rxwr); \
-	}
+#define setSn_RX_WR(sn, rxwr) \
+		WIZCHIP_WRITE_WORD(Sn_RX_WR(sn), (uint16_t)(rxwr))
 
 
 /**
@@ -3055,7 +3103,7 @@ uint16_t getSn_RX_RSR(uint8_t sn);
  * @return uint16_t. Value of @ref Sn_RX_WR.
  */
 #define getSn_RX_WR(sn) \
-		(((uint16_t)WIZCHIP_READ(Sn_RX_WR(sn)) << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_RX_WR(sn),1)))
+		WIZCHIP_READ_WORD(Sn_RX_WR(sn))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -3064,10 +3112,8 @@ uint16_t getSn_RX_RSR(uint8_t sn);
  * @param (uint16_t)frag Value to set \ref Sn_FRAGR
  * @sa getSn_FRAG()
  */
-#define setSn_FRAGR(sn, fragr) { \
-		WIZCHIP_WRITE(Sn_FRAGR(sn),  (uint8_t)(fragr >>8)); \
-		WIZCHIP_WRITE(WIZCHIP_OFFSET_INC(Sn_FRAGR(sn),1), (uint8_t) fragr); \
-	}
+#define setSn_FRAGR(sn, fragr) \
+		WIZCHIP_WRITE_WORD(Sn_FRAGR(sn), (uint16_t)(fragr))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -3077,7 +3123,7 @@ uint16_t getSn_RX_RSR(uint8_t sn);
  * @sa setSn_FRAG()
  */
 #define getSn_FRAGR(sn) \
-		(((uint16_t)WIZCHIP_READ(Sn_FRAGR(sn)) << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_FRAGR(sn),1)))
+		WIZCHIP_READ_WORD(Sn_FRAGR(sn))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -3085,8 +3131,7 @@ uint16_t getSn_RX_RSR(uint8_t sn);
  * @param (uint8_t)sn Socket number. It should be <b>0 ~ @ref \_WIZCHIP_SOCK_NUM_</b>.
  * @return uint16_t. Max buffer size
  */
-#define getSn_RxMAX(sn) \
-		((uint16_t)(0x0001 << getSn_RXMEM_SIZE(sn)) << 10)
+uint16_t getSn_RxMAX(uint8_t sn);
 
 
 /**
@@ -3095,8 +3140,7 @@ uint16_t getSn_RX_RSR(uint8_t sn);
  * @param (uint8_t)sn Socket number. It should be <b>0 ~ @ref \_WIZCHIP_SOCK_NUM_</b>.
  * @return uint16_t. Max buffer size
  */
-#define getSn_TxMAX(sn) \
-		((uint16_t)(0x0001 << getSn_TXMEM_SIZE(sn)) << 10)
+uint16_t getSn_TxMAX(uint8_t sn);
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -3133,6 +3177,21 @@ uint32_t getSn_RxBASE(uint8_t sn);
  */
 uint32_t getSn_TxBASE(uint8_t sn);
 
+/**
+ * @ingroup Socket_register_access_function_W5100S
+ * @brief Load the TX and RX buffer layout of all sockets from @ref TMSR and @ref RMSR.
+ * @details getSn_TxMAX(), getSn_RxMAX(), their masks and getSn_TxBASE(), getSn_RxBASE() answer from it
+ * without an access to the chip. It is being called by socket(), and on first use after wiz_sock_mem_clear().
+ */
+void wiz_sock_mem_load(void);
+
+/**
+ * @ingroup Socket_register_access_function_W5100S
+ * @brief Drop the buffer layout loaded by wiz_sock_mem_load().
+ * @details It is being called when @ref TMSR or @ref RMSR is written and on software reset.
+ */
+void wiz_sock_mem_clear(void);
+
 
 /*socket register W5100S only*/
 
@@ -3206,10 +3265,8 @@ uint32_t getSn_TxBASE(uint8_t sn);
  * @param (uint8_t)sn Socket number. It should be <b>0 ~ @ref \_WIZCHIP_SOCK_NUM_</b>.
  * @param (uint16_t)rtr Value of the Socket n Sn_RTR register to set.
  */
-#define	setSn_RTR(sn,rtr)	{ \
-		WIZCHIP_WRITE(Sn_RTR(sn),   (uint8_t)(rtr >> 8)); \
-		WIZCHIP_WRITE(WIZCHIP_OFFSET_INC(Sn_RTR(sn),1), (uint8_t) rtr); \
-		}
+#define	setSn_RTR(sn,rtr)	\
+		WIZCHIP_WRITE_WORD(Sn_RTR(sn), (uint16_t)(rtr))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -3218,7 +3275,7 @@ uint32_t getSn_TxBASE(uint8_t sn);
  * @return uint16_t. Value of the Socket n Sn_RTR register.
  */
 #define getSn_RTR(sn)	\
-		(((uint16_t)WIZCHIP_READ(Sn_RTR(sn)) << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_RTR(sn),1)))
+		WIZCHIP_READ_WORD(Sn_RTR(sn))
 
 /**
  * @ingroup Socket_register_access_function_W5100S
@@ -3257,6 +3314,39 @@ uint32_t getSn_TxBASE(uint8_t sn);
  */
 void wiz_send_data(uint8_t sn, uint8_t *wizdata, uint16_t len);
 
+/**
+ * @ingroup Special_function_W5100S
+ * @brief It copies pieces of data to internal TX memory as one datagram
+ *
+ * @details Like wiz_send_data(), without gathering the pieces in MCU memory first.
+ * The pieces are split where the TX ring wraps and each side is written in one SPI frame.
+ * This function is being called by sendto_vec().
+ *
+ * @param sn Socket number. It should be <b>0 ~ @ref \_WIZCHIP_SOCK_NUM_</b>.
+ * @param vec Pieces of data, at most @ref WIZ_IOVEC_MAX
+ * @param cnt Number of pieces
+ * @sa wiz_send_data()
+ */
+void wiz_send_data_vec(uint8_t sn, wiz_IOVec *vec, uint8_t cnt);
+
+/**
+ * @ingroup Special_function_W5100S
+ * @brief It copies pieces of data to internal TX memory without moving Sn_TX_WR
+ *
+ * @details Like wiz_send_data_vec(), but the data goes at <i>ptr</i>, which may be ahead of Sn_TX_WR,
+ * and Sn_TX_WR is left as it is. Several datagrams can so be written ahead and sent one by one later.
+ * With an asynchronous SPI burst registered it may return before the data is written, see WIZCHIP_WRITE_BUF_VEC_ASYNC().
+ * This function is being called by sendto_async() and wiz_send_data_vec().
+ *
+ * @param sn Socket number. It should be <b>0 ~ @ref \_WIZCHIP_SOCK_NUM_</b>.
+ * @param ptr TX pointer to write at, in the same units as Sn_TX_WR
+ * @param vec Pieces of data, at most @ref WIZ_IOVEC_MAX
+ * @param cnt Number of pieces
+ * @return Bytes written
+ * @sa wiz_send_data_vec()
+ */
+uint16_t wiz_put_data_vec(uint8_t sn, uint16_t ptr, wiz_IOVec *vec, uint8_t cnt);
+
 /**
  * @ingroup Basic_IO_function_W5100S
  * @brief It copies data to your buffer from internal RX memory
@@ -74,6 +74,40 @@ uint8_t  sock_pack_info[_WIZCHIP_SOCK_NUM_] = {0,};
    static uint16_t sock_next_rd[_WIZCHIP_SOCK_NUM_] ={0,};
 #endif
 
+#if _WIZCHIP_ == W5100S
+//Datagrams written ahead into the TX buffer by sendto_async(), sent one by one
+typedef struct
+{
+   uint16_t len;
+   uint8_t  addr[4];
+   uint16_t port;
+}sock_async_entry;
+
+typedef struct
+{
+   sock_async_entry entry[SOCK_ASYNC_DEPTH];
+   uint8_t  head;      // oldest datagram, the one being sent when issued is set
+   uint8_t  count;     // datagrams not confirmed yet
+   uint8_t  issued;    // SEND of the oldest datagram is in progress
+   uint16_t tx_wr;     // Sn_TX_WR, the end of the datagrams already sent or being sent
+   uint16_t wr;        // end of the datagrams written ahead
+   uint16_t used;      // bytes of the datagrams not confirmed yet
+   uint8_t  dest[6];   // Sn_DIPR and Sn_DPORT as last written by sendto_async_issue()
+   uint8_t  dest_valid;
+}sock_async_info;
+
+static sock_async_info sock_async[_WIZCHIP_SOCK_NUM_];
+
+static void sendto_async_reset(uint8_t sn)
+{
+   sock_async[sn].head = 0;
+   sock_async[sn].count = 0;
+   sock_async[sn].issued = 0;
+   sock_async[sn].used = 0;
+   sock_async[sn].dest_valid = 0;
+}
+#endif
+
 //A20150601 : For integrating with W5300
 #if _WIZCHIP_ == 5300
    uint8_t sock_remained_byte[_WIZCHIP_SOCK_NUM_] = {0,}; // set by wiz_recv_data()
@@ -187,10 +221,17 @@ int8_t socket(uint8_t sn, uint8_t protocol, uint16_t port, uint8_t flag)
 	sock_io_mode |= ((flag & SF_IO_NONBLOCK) << sn);   
    sock_is_sending &= ~(1<<sn);
    sock_remained_size[sn] = 0;
+#if _WIZCHIP_ == W5100S
+   sendto_async_reset(sn);
+#endif
    //M20150601 : repalce 0 with PACK_COMPLETED
    //sock_pack_info[sn] = 0;
    sock_pack_info[sn] = PACK_COMPLETED;
    //
+#if _WIZCHIP_ == W5100S
+   //Buffer sizes and bases are fixed from here, no more TMSR/RMSR reads per send and receive
+   wiz_sock_mem_load();
+#endif
    while(getSn_SR(sn) == SOCK_CLOSED);
    return (int8_t)sn;
 }	   
@@ -234,6 +275,9 @@ int8_t close(uint8_t sn)
 	sock_is_sending &= ~(1<<sn);
 	sock_remained_size[sn] = 0;
 	sock_pack_info[sn] = 0;
+#if _WIZCHIP_ == W5100S
+	sendto_async_reset(sn);
+#endif
 	while(getSn_SR(sn) != SOCK_CLOSED);
 	return SOCK_OK;
 }
@@ -487,7 +531,8 @@ int32_t recv(uint8_t sn, uint8_t * buf, uint16_t len)
    return (int32_t)len;
 }
 
-int32_t sendto(uint8_t sn, uint8_t * buf, uint16_t len, uint8_t * addr, uint16_t port)
+//Shared by sendto() and sendto_vec(), checks the socket and waits for TX room. Returns the length to send.
+static int32_t sendto_prepare(uint8_t sn, uint16_t len, uint8_t * addr, uint16_t port)
 {
    uint8_t tmp = 0;
    uint16_t freesize = 0;
@@ -507,6 +552,14 @@ int32_t sendto(uint8_t sn, uint8_t * buf, uint16_t len, uint8_t * addr, uint16_t
          return SOCKERR_SOCKMODE;
    }
    CHECK_SOCKDATA();
+#if _WIZCHIP_ == W5100S
+   //Datagrams written ahead sit past Sn_TX_WR, let them go before writing there
+   while(sock_async[sn].count)
+   {
+      if(sendto_async_poll(sn) == SOCKERR_SOCKCLOSED) return SOCKERR_SOCKCLOSED;
+   }
+   sock_async[sn].dest_valid = 0;
+#endif
    //M20140501 : For avoiding fatal error on memory align mismatched
    //if(*((uint32_t*)addr) == 0) return SOCKERR_IPINVALID;
    //{
@@ -538,7 +591,14 @@ int32_t sendto(uint8_t sn, uint8_t * buf, uint16_t len, uint8_t * addr, uint16_t
       if( (sock_io_mode & (1<<sn)) && (len > freesize) ) return SOCK_BUSY;
       if(len <= freesize) break;
    };
-	wiz_send_data(sn, buf, len);
+   return (int32_t)len;
+}
+
+//Shared by sendto() and sendto_vec(), sends what is in the TX buffer and waits for the result.
+static int32_t sendto_start(uint8_t sn, uint16_t len)
+{
+   uint8_t tmp = 0;
+   uint32_t taddr;
 
    #if _WIZCHIP_ < 5500   //M20150401 : for WIZCHIP Errata #4, #5 (ARP errata)
       getSIPR((uint8_t*)&taddr);
@@ -591,6 +651,162 @@ int32_t sendto(uint8_t sn, uint8_t * buf, uint16_t len, uint8_t * addr, uint16_t
 
 
 
+int32_t sendto(uint8_t sn, uint8_t * buf, uint16_t len, uint8_t * addr, uint16_t port)
+{
+   int32_t ret;
+
+   ret = sendto_prepare(sn, len, addr, port);
+   if(ret <= 0) return ret;
+   len = (uint16_t)ret;
+	wiz_send_data(sn, buf, len);
+   return sendto_start(sn, len);
+}
+
+#if _WIZCHIP_ == W5100S
+int32_t sendto_vec(uint8_t sn, wiz_IOVec * vec, uint8_t cnt, uint8_t * addr, uint16_t port)
+{
+   int32_t ret;
+   uint32_t len = 0;
+   uint8_t i;
+
+   CHECK_SOCKNUM();
+   if((cnt == 0) || (cnt > WIZ_IOVEC_MAX)) return SOCKERR_ARG;
+   for(i = 0; i < cnt; i++) len += vec[i].len;
+   //A datagram is never cut, it has to fit the TX buffer whole.
+   if((len == 0) || (len > getSn_TxMAX(sn))) return SOCKERR_DATALEN;
+
+   ret = sendto_prepare(sn, (uint16_t)len, addr, port);
+   if(ret <= 0) return ret;
+   wiz_send_data_vec(sn, vec, cnt);
+   return sendto_start(sn, (uint16_t)len);
+}
+
+//Start SEND of the oldest datagram written ahead, the chip takes Sn_TX_RD ~ Sn_TX_WR as one datagram
+static void sendto_async_issue(uint8_t sn)
+{
+   sock_async_info* info = &sock_async[sn];
+   sock_async_entry* e;
+   uint8_t dest[6];
+   uint8_t same;
+   uint8_t i;
+
+   if(info->issued || (info->count == 0)) return;
+
+   e = &info->entry[info->head];
+   //Sn_DIPR and Sn_DPORT are adjacent, one frame for both and none when the destination is the same
+   for(i = 0; i < 4; i++) dest[i] = e->addr[i];
+   dest[4] = (uint8_t)(e->port >> 8);
+   dest[5] = (uint8_t)e->port;
+   same = info->dest_valid;
+   for(i = 0; i < 6; i++)
+   {
+      if(dest[i] != info->dest[i]) same = 0;
+      info->dest[i] = dest[i];
+   }
+   if(!same) WIZCHIP_WRITE_BUF(Sn_DIPR(sn), dest, 6);
+   info->dest_valid = 1;
+   info->tx_wr += e->len;
+   setSn_TX_WR(sn, info->tx_wr);
+   //The command register clears long before SENDOK, so it is not polled here
+   setSn_CR(sn, Sn_CR_SEND);
+   info->issued = 1;
+}
+
+int32_t sendto_async(uint8_t sn, wiz_IOVec * vec, uint8_t cnt, uint8_t * addr, uint16_t port)
+{
+   sock_async_info* info;
+   sock_async_entry* e;
+   uint32_t taddr;
+   uint32_t len = 0;
+   uint8_t i;
+
+   CHECK_SOCKNUM();
+   if((getSn_MR(sn) & 0x0F) != Sn_MR_UDP) return SOCKERR_SOCKMODE;
+   if((cnt == 0) || (cnt > WIZ_IOVEC_MAX)) return SOCKERR_ARG;
+   for(i = 0; i < cnt; i++) len += vec[i].len;
+   if((len == 0) || (len > getSn_TxMAX(sn))) return SOCKERR_DATALEN;
+   taddr = ((uint32_t)addr[0] << 24) | ((uint32_t)addr[1] << 16) | ((uint32_t)addr[2] << 8) | (uint32_t)addr[3];
+   if(taddr == 0) return SOCKERR_IPINVALID;
+   if(port == 0) return SOCKERR_PORTZERO;
+
+   //Confirm what the chip has sent meanwhile, one Sn_IR read
+   if(sendto_async_poll(sn) == SOCKERR_SOCKCLOSED) return SOCKERR_SOCKCLOSED;
+
+   info = &sock_async[sn];
+   if((info->count >= SOCK_ASYNC_DEPTH) || (info->used + len > getSn_TxMAX(sn))) return SOCK_BUSY;
+
+   if(info->count == 0)
+   {
+      info->tx_wr = getSn_TX_WR(sn);
+      info->wr = info->tx_wr;
+   }
+
+   wiz_put_data_vec(sn, info->wr, vec, cnt);
+   info->wr += (uint16_t)len;
+   info->used += (uint16_t)len;
+
+   e = &info->entry[(info->head + info->count) % SOCK_ASYNC_DEPTH];
+   e->len = (uint16_t)len;
+   for(i = 0; i < 4; i++) e->addr[i] = addr[i];
+   e->port = port;
+   info->count++;
+
+   //An asynchronous SPI burst may still be writing the data, a SEND now would wait for it.
+   //Then the next call or sendto_async_poll() issues it, once the CPU had other work to do
+   if(!WIZCHIP.IF.SPI._write_burst_vec_async) sendto_async_issue(sn);
+   return (int32_t)len;
+}
+
+int32_t sendto_async_poll(uint8_t sn)
+{
+   sock_async_info* info;
+   uint8_t tmp;
+   int32_t ret = 0;
+
+   CHECK_SOCKNUM();
+   info = &sock_async[sn];
+   if(!info->issued)
+   {
+      sendto_async_issue(sn);
+      return 0;
+   }
+
+   tmp = getSn_IR(sn);
+   if(tmp & (Sn_IR_SENDOK | Sn_IR_TIMEOUT))
+   {
+      if(tmp & Sn_IR_SENDOK)
+      {
+         setSn_IR(sn, Sn_IR_SENDOK);
+         ret = 1;
+      }
+      else
+      {
+         //ARP failed, the datagram is dropped like sendto() drops it
+         setSn_IR(sn, Sn_IR_TIMEOUT);
+         ret = SOCKERR_TIMEOUT;
+      }
+      info->used -= info->entry[info->head].len;
+      info->head = (info->head + 1) % SOCK_ASYNC_DEPTH;
+      info->count--;
+      info->issued = 0;
+      sendto_async_issue(sn);
+   }
+   else if(getSn_SR(sn) == SOCK_CLOSED)
+   {
+      sendto_async_reset(sn);
+      ret = SOCKERR_SOCKCLOSED;
+   }
+
+   return ret;
+}
+
+uint8_t sendto_async_pending(uint8_t sn)
+{
+   if(sn >= _WIZCHIP_SOCK_NUM_) return 0;
+   return sock_async[sn].count;
+}
+#endif
+
 int32_t recvfrom(uint8_t sn, uint8_t * buf, uint16_t len, uint8_t * addr, uint16_t *port)
 {
 //M20150601 : For W5300   
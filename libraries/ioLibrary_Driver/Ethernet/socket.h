@@ -113,6 +113,10 @@
 
 #define SOCKFATAL_PACKLEN     (SOCK_FATAL - 1)     ///< Invalid packet length. Fatal Error.
 
+#if _WIZCHIP_ == W5100S
+#define SOCK_ASYNC_DEPTH      8        ///< Datagrams @ref sendto_async() can write ahead per socket, bounded by the socket TX buffer too.
+#endif
+
 /*
  * SOCKET FLAG
  */
@@ -299,6 +303,84 @@ int32_t recv(uint8_t sn, uint8_t * buf, uint16_t len);
  */
 int32_t sendto(uint8_t sn, uint8_t * buf, uint16_t len, uint8_t * addr, uint16_t port);
 
+#if _WIZCHIP_ == W5100S
+/**
+ * @ingroup WIZnet_socket_APIs
+ * @brief	Sends one datagram gathered from several buffers.
+ * @details Same as @ref sendto(), but the datagram is the pieces of <I>vec</I> in order, written to the
+ *          socket TX buffer without copying them together first. Unlike @ref sendto() the datagram is never
+ *          cut to the buffer size.
+ *
+ * @param sn    Socket number. It should be <b>0 ~ @ref \_WIZCHIP_SOCK_NUM_</b>.
+ * @param vec   Pieces of the datagram.
+ * @param cnt   Number of pieces, 1 ~ @ref WIZ_IOVEC_MAX.
+ * @param addr  Pointer variable of destination IP address. It should be allocated 4 bytes.
+ * @param port  Destination port number.
+ *
+ * @return @b Success : The sent data size \n
+ *         @b Fail    :\n @ref SOCKERR_ARG         - Invalid piece count \n
+ *                        @ref SOCKERR_DATALEN     - Zero length or larger than the socket TX buffer \n
+ *                        Otherwise the same as @ref sendto().
+ */
+int32_t sendto_vec(uint8_t sn, wiz_IOVec * vec, uint8_t cnt, uint8_t * addr, uint16_t port);
+
+/**
+ * @ingroup WIZnet_socket_APIs
+ * @brief	Submits one UDP datagram without waiting for it to be sent.
+ * @details The pieces are written into the socket TX buffer behind the datagrams submitted before,
+ *          and SEND is issued as soon as the chip is done with the previous one, so up to
+ *          @ref SOCK_ASYNC_DEPTH datagrams can wait in the TX buffer. Nothing is polled in a loop:
+ *          each call confirms what the chip has sent meanwhile with one Sn_IR read, and
+ *          @ref sendto_async_poll() does the same from the main loop.\n
+ *          With an asynchronous SPI burst registered (@ref reg_wizchip_spiburst_async_cbfunc()) the call returns
+ *          while the data is still being written, and SEND is left to the next call or @ref sendto_async_poll(),
+ *          which must then come. The pieces must stay unchanged until the next access to the chip.\n
+ *          @ref sendto(), @ref sendto_vec(), @ref close() and @ref socket() on the same socket
+ *          let the submitted datagrams go first, or drop them in the case of close.
+ * @note    It never blocks. The ARP errata workaround of @ref sendto() is not applied,
+ *          so the source IP address must be set.
+ *
+ * @param sn    Socket number. It should be <b>0 ~ @ref \_WIZCHIP_SOCK_NUM_</b>.
+ * @param vec   Pieces of the datagram.
+ * @param cnt   Number of pieces, 1 ~ @ref WIZ_IOVEC_MAX.
+ * @param addr  Pointer variable of destination IP address. It should be allocated 4 bytes.
+ * @param port  Destination port number.
+ *
+ * @return @b Success : The submitted data size \n
+ *         @b Fail    :\n @ref SOCKERR_SOCKNUM     - Invalid socket number \n
+ *                        @ref SOCKERR_SOCKMODE    - Not a UDP socket \n
+ *                        @ref SOCKERR_ARG         - Invalid piece count \n
+ *                        @ref SOCKERR_DATALEN     - Zero length or larger than the socket TX buffer \n
+ *                        @ref SOCKERR_IPINVALID   - Wrong server IP address\n
+ *                        @ref SOCKERR_PORTZERO    - Server port zero\n
+ *                        @ref SOCKERR_SOCKCLOSED  - Socket unexpectedly closed \n
+ *                        @ref SOCK_BUSY           - No room for the datagram yet, try again after @ref sendto_async_poll().
+ */
+int32_t sendto_async(uint8_t sn, wiz_IOVec * vec, uint8_t cnt, uint8_t * addr, uint16_t port);
+
+/**
+ * @ingroup WIZnet_socket_APIs
+ * @brief	Confirms the datagram being sent by @ref sendto_async() and starts the next one.
+ * @details Reads Sn_IR once when a SEND is in progress, otherwise issues the SEND of the oldest datagram waiting.
+ *
+ * @param sn    Socket number. It should be <b>0 ~ @ref \_WIZCHIP_SOCK_NUM_</b>.
+ *
+ * @return 1 when a datagram was sent, 0 when none completed \n
+ *         @ref SOCKERR_SOCKNUM     - Invalid socket number \n
+ *         @ref SOCKERR_TIMEOUT     - The datagram was dropped on ARP timeout \n
+ *         @ref SOCKERR_SOCKCLOSED  - Socket closed, the submitted datagrams are dropped
+ */
+int32_t sendto_async_poll(uint8_t sn);
+
+/**
+ * @ingroup WIZnet_socket_APIs
+ * @brief	Number of datagrams submitted by @ref sendto_async() and not confirmed yet.
+ *
+ * @param sn    Socket number. It should be <b>0 ~ @ref \_WIZCHIP_SOCK_NUM_</b>.
+ */
+uint8_t sendto_async_pending(uint8_t sn);
+#endif
+
 /**
  * @ingroup WIZnet_socket_APIs
  * @brief Receive datagram of UDP or MACRAW
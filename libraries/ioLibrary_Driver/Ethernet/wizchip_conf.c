@@ -281,6 +281,27 @@ void reg_wizchip_spiburst_cbfunc(void (*spi_rb)(uint8_t* pBuf, uint16_t len), vo
    }
 }
 
+void reg_wizchip_spiburst_vec_cbfunc(void (*spi_wbv)(wiz_IOVec* vec, uint8_t cnt))
+{
+   while(!(WIZCHIP.if_mode & _WIZCHIP_IO_MODE_SPI_));
+
+   WIZCHIP.IF.SPI._write_burst_vec = spi_wbv;
+}
+
+void reg_wizchip_spiburst_async_cbfunc(void (*spi_wbva)(wiz_IOVec* vec, uint8_t cnt))
+{
+   while(!(WIZCHIP.if_mode & _WIZCHIP_IO_MODE_SPI_));
+
+   WIZCHIP.IF.SPI._write_burst_vec_async = spi_wbva;
+}
+
+void reg_wizchip_spiframe_cbfunc(void (*spi_frame)(wiz_IOVec* tx, uint8_t cnt, uint8_t* rx, uint16_t rxlen))
+{
+   while(!(WIZCHIP.if_mode & _WIZCHIP_IO_MODE_SPI_));
+
+   WIZCHIP.IF.SPI._frame = spi_frame;
+}
+
 int8_t ctlwizchip(ctlwizchip_type cwtype, void* arg)
 {
 #if	_WIZCHIP_ == W5100S || _WIZCHIP_ == W5200 || _WIZCHIP_ == W5500
@@ -406,6 +427,9 @@ void wizchip_sw_reset(void)
    getGAR(gw);  getSUBR(sn);  getSIPR(sip);
    setMR(MR_RST);
    getMR(); // for delay
+#if _WIZCHIP_ == W5100S
+   wiz_sock_mem_clear();   // TMSR and RMSR are back to their defaults
+#endif
 //A2015051 : For indirect bus mode 
 #if _WIZCHIP_IO_MODE_  == _WIZCHIP_IO_MODE_BUS_INDIR_
    setMR(mr | MR_IND);
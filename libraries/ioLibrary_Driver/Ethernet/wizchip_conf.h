@@ -59,6 +59,22 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+
+/**
+ * @ingroup DATA_TYPE
+ * @brief A piece of data written to the WIZCHIP in place, without gathering the pieces first
+ * @sa sendto_vec(), wiz_send_data_vec()
+ */
+typedef struct wiz_IOVec_t
+{
+   uint8_t* buf;   ///< Start of the piece
+   uint16_t len;   ///< Length of the piece
+}wiz_IOVec;
+
+#define WIZ_IOVEC_MAX   4   ///< Pieces in one sendto_vec(). The SPI frame header and the TX ring wrap add up to two more inside.
+
+#define _WIZCHIP_SPI_BURST_MIN_   16   ///< Buffer accesses shorter than this go byte by byte, a burst setup costs more. Registers always do.
+
 /**
  * @brief Select WIZCHIP.
  * @todo You should select one, \b W5100, \b W5100S, \b W5200, \b W5300, \b W5500 or etc. \n\n
@@ -279,6 +295,9 @@ typedef struct __WIZCHIP
          void    (*_write_byte)  (uint8_t wb);
          void    (*_read_burst)  (uint8_t* pBuf, uint16_t len);
          void    (*_write_burst) (uint8_t* pBuf, uint16_t len);
+         void    (*_write_burst_vec) (wiz_IOVec* vec, uint8_t cnt);   ///< Optional, NULL writes piece by piece
+         void    (*_write_burst_vec_async) (wiz_IOVec* vec, uint8_t cnt);   ///< Optional, returns at once and deselects when done
+         void    (*_frame) (wiz_IOVec* tx, uint8_t cnt, uint8_t* rx, uint16_t rxlen);   ///< Optional, whole transaction with its own chip select
       }SPI;
       // To be added
       //
@@ -504,6 +523,32 @@ void reg_wizchip_spi_cbfunc(uint8_t (*spi_rb)(void), void (*spi_wb)(uint8_t wb))
  */
 void reg_wizchip_spiburst_cbfunc(void (*spi_rb)(uint8_t* pBuf, uint16_t len), void (*spi_wb)(uint8_t* pBuf, uint16_t len));
 
+/**
+ *@brief Registers call back function for gathered SPI burst write.
+ *@param spi_wbv : callback function to write several pieces back to back in one SPI frame
+ *@note If you do not register, or register NULL, the pieces are written one by one with the burst write.
+ */
+void reg_wizchip_spiburst_vec_cbfunc(void (*spi_wbv)(wiz_IOVec* vec, uint8_t cnt));
+
+/**
+ *@brief Registers call back function for asynchronous gathered SPI burst write.
+ *@param spi_wbva : callback function that starts writing the pieces in one SPI frame and returns.
+ *       When the transfer ends it deselects the chip itself, and the critical section enter
+ *       callback waits for that, so the next access never overlaps it.
+ *       The piece list may be reused at return, the data only after the next access.
+ *@note If you do not register, or register NULL, the synchronous gathered write is used.
+ */
+void reg_wizchip_spiburst_async_cbfunc(void (*spi_wbva)(wiz_IOVec* vec, uint8_t cnt));
+
+/**
+ *@brief Registers call back function for whole SPI transactions.
+ *@param spi_frame : callback function that selects the chip, writes the pieces of <i>tx</i> back to back,
+ *       opcode and address included, then reads <i>rxlen</i> bytes into <i>rx</i> and deselects the chip.
+ *       It is for interfaces that frame a transaction in hardware, the chip select callbacks are then not called.
+ *@note If you do not register, or register NULL, transactions are made of chip select, byte and burst callbacks.
+ */
+void reg_wizchip_spiframe_cbfunc(void (*spi_frame)(wiz_IOVec* tx, uint8_t cnt, uint8_t* rx, uint16_t rxlen));
+
 /**
  * @ingroup extra_functions
  * @brief Controls to the WIZCHIP.
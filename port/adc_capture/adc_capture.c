@@ -0,0 +1,246 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#include "adc_capture.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Buffer */
+static uint16_t g_adc_capture_buf[ADC_CAPTURE_BUFFER_COUNT][ADC_CAPTURE_FRAME_SAMPLES_MAX] __attribute__((aligned(4)));
+static uint16_t g_adc_capture_frame_samples = ADC_CAPTURE_FRAME_SAMPLES;
+
+/* DMA */
+static uint g_adc_capture_dma[ADC_CAPTURE_BUFFER_COUNT];
+static dma_channel_config g_adc_capture_dma_config[ADC_CAPTURE_BUFFER_COUNT];
+
+/* Status */
+static volatile uint8_t g_adc_capture_ready[ADC_CAPTURE_BUFFER_COUNT];
+static volatile uint32_t g_adc_capture_overrun = 0;
+static uint8_t g_adc_capture_read_index = 0;
+
+/* Input */
+static uint8_t g_adc_capture_first_input = 0;
+
+/* Timestamp */
+static volatile uint64_t g_adc_capture_time[ADC_CAPTURE_BUFFER_COUNT];
+static volatile uint64_t g_adc_capture_index[ADC_CAPTURE_BUFFER_COUNT];
+static uint64_t g_adc_capture_sample_count = 0;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+static void adc_capture_dma_handler(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < ADC_CAPTURE_BUFFER_COUNT; i++)
+    {
+        if (!dma_channel_get_irq0_status(g_adc_capture_dma[i]))
+            continue;
+
+        dma_channel_acknowledge_irq0(g_adc_capture_dma[i]);
+
+        /* Stamp first, the frame is complete as of now */
+        g_adc_capture_time[i] = time_us_64();
+        g_adc_capture_index[i] = g_adc_capture_sample_count;
+        g_adc_capture_sample_count += g_adc_capture_frame_samples;
+
+        /* Re-arm without triggering, the other channel chains back to this one */
+        dma_channel_set_write_addr(g_adc_capture_dma[i], g_adc_capture_buf[i], false);
+
+        if (g_adc_capture_ready[i])
+            g_adc_capture_overrun++;
+
+        g_adc_capture_ready[i] = 1;
+    }
+}
+
+void adc_capture_initialize(uint8_t adc_num, float clkdiv)
+{
+    uint8_t i;
+
+    adc_init();
+    adc_gpio_init(26 + adc_num);
+    adc_select_input(adc_num);
+    g_adc_capture_first_input = adc_num;
+
+    adc_fifo_setup(
+        true,  // Write each completed conversion to the sample FIFO
+        true,  // Enable DMA data request (DREQ)
+        1,     // DREQ (and IRQ) asserted when at least 1 sample present
+        true,  // Keep the ERR bit in bit 15 of each sample
+        false  // Keep full 12-bit samples, DMA reads 16-bit words
+    );
+    adc_set_clkdiv(clkdiv);
+
+    for (i = 0; i < ADC_CAPTURE_BUFFER_COUNT; i++)
+        g_adc_capture_dma[i] = dma_claim_unused_channel(true);
+
+    for (i = 0; i < ADC_CAPTURE_BUFFER_COUNT; i++)
+    {
+        g_adc_capture_dma_config[i] = dma_channel_get_default_config(g_adc_capture_dma[i]);
+        channel_config_set_transfer_data_size(&g_adc_capture_dma_config[i], DMA_SIZE_16);
+        channel_config_set_read_increment(&g_adc_capture_dma_config[i], false);
+        channel_config_set_write_increment(&g_adc_capture_dma_config[i], true);
+        channel_config_set_dreq(&g_adc_capture_dma_config[i], DREQ_ADC);
+        channel_config_set_chain_to(&g_adc_capture_dma_config[i], g_adc_capture_dma[(i + 1) % ADC_CAPTURE_BUFFER_COUNT]);
+
+        dma_channel_configure(g_adc_capture_dma[i], &g_adc_capture_dma_config[i],
+                              g_adc_capture_buf[i],      // write address
+                              &adc_hw->fifo,             // read address
+                              ADC_CAPTURE_FRAME_SAMPLES, // element count
+                              false);                    // don't start yet
+
+        dma_channel_set_irq0_enabled(g_adc_capture_dma[i], true);
+    }
+
+    irq_add_shared_handler(ADC_CAPTURE_DMA_IRQ, adc_capture_dma_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(ADC_CAPTURE_DMA_IRQ, true);
+}
+
+void adc_capture_configure(float clkdiv, uint16_t frame_samples)
+{
+    if (clkdiv < ADC_CAPTURE_CLKDIV_MIN)
+        clkdiv = ADC_CAPTURE_CLKDIV_MIN;
+
+    if (frame_samples == 0)
+        frame_samples = ADC_CAPTURE_FRAME_SAMPLES;
+    else if (frame_samples > ADC_CAPTURE_FRAME_SAMPLES_MAX)
+        frame_samples = ADC_CAPTURE_FRAME_SAMPLES_MAX;
+
+    adc_set_clkdiv(clkdiv);
+    g_adc_capture_frame_samples = frame_samples;
+}
+
+uint8_t adc_capture_set_inputs(uint8_t input_mask)
+{
+    uint8_t count = 0;
+    uint8_t i;
+
+    input_mask &= ADC_CAPTURE_INPUT_MASK;
+
+    if (input_mask == 0)
+        input_mask = 1u << g_adc_capture_first_input;
+
+    for (i = ADC_CAPTURE_INPUT_COUNT; i > 0; i--)
+    {
+        if (input_mask & (1u << (i - 1)))
+        {
+            adc_gpio_init(26 + (i - 1));
+            g_adc_capture_first_input = i - 1;
+            count++;
+        }
+    }
+
+    /* Round-robin steps up from the selected input, a single input disables it */
+    adc_select_input(g_adc_capture_first_input);
+    adc_set_round_robin((count > 1) ? input_mask : 0);
+
+    return count;
+}
+
+uint16_t adc_capture_get_frame_samples(void)
+{
+    return g_adc_capture_frame_samples;
+}
+
+void adc_capture_start(void)
+{
+    uint8_t i;
+
+    adc_run(false);
+    adc_fifo_drain();
+
+    /* Round-robin leaves AINSEL wherever the last conversion stopped, every frame must start at the first input */
+    adc_select_input(g_adc_capture_first_input);
+
+    for (i = 0; i < ADC_CAPTURE_BUFFER_COUNT; i++)
+    {
+        g_adc_capture_ready[i] = 0;
+        dma_channel_set_write_addr(g_adc_capture_dma[i], g_adc_capture_buf[i], false);
+        dma_channel_set_trans_count(g_adc_capture_dma[i], g_adc_capture_frame_samples, false);
+    }
+    g_adc_capture_read_index = 0;
+    g_adc_capture_overrun = 0;
+    g_adc_capture_sample_count = 0;
+
+    dma_channel_start(g_adc_capture_dma[0]);
+    adc_run(true);
+}
+
+void adc_capture_stop(void)
+{
+    uint8_t i;
+    uint32_t mask = 0;
+
+    adc_run(false);
+
+    for (i = 0; i < ADC_CAPTURE_BUFFER_COUNT; i++)
+    {
+        dma_channel_set_irq0_enabled(g_adc_capture_dma[i], false);
+        mask |= 1u << g_adc_capture_dma[i];
+    }
+
+    /* Abort both at once so neither can chain-trigger the other */
+    dma_hw->abort = mask;
+    while (dma_hw->abort & mask)
+        tight_loop_contents();
+
+    for (i = 0; i < ADC_CAPTURE_BUFFER_COUNT; i++)
+    {
+        dma_channel_acknowledge_irq0(g_adc_capture_dma[i]);
+        dma_channel_set_irq0_enabled(g_adc_capture_dma[i], true);
+        g_adc_capture_ready[i] = 0;
+    }
+
+    adc_fifo_drain();
+}
+
+uint16_t *adc_capture_get_frame(void)
+{
+    if (!g_adc_capture_ready[g_adc_capture_read_index])
+        return NULL;
+
+    return g_adc_capture_buf[g_adc_capture_read_index];
+}
+
+void adc_capture_release_frame(void)
+{
+    g_adc_capture_ready[g_adc_capture_read_index] = 0;
+    g_adc_capture_read_index = (g_adc_capture_read_index + 1) % ADC_CAPTURE_BUFFER_COUNT;
+}
+
+uint64_t adc_capture_get_frame_time(void)
+{
+    return g_adc_capture_time[g_adc_capture_read_index];
+}
+
+uint64_t adc_capture_get_frame_index(void)
+{
+    return g_adc_capture_index[g_adc_capture_read_index];
+}
+
+uint32_t adc_capture_get_overrun(void)
+{
+    return g_adc_capture_overrun;
+}
@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _ADC_CAPTURE_H_
+#define _ADC_CAPTURE_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Frame */
+#define ADC_CAPTURE_FRAME_SAMPLES 250     // default samples per DMA frame (500 bytes)
+#define ADC_CAPTURE_FRAME_SAMPLES_MAX 256 // ping-pong buffer size
+#define ADC_CAPTURE_BUFFER_COUNT 2        // ping-pong
+
+/* Input */
+#define ADC_CAPTURE_INPUT_COUNT 4   // ADC inputs 0 ~ 3 (GPIO 26 ~ 29)
+#define ADC_CAPTURE_INPUT_MASK 0x0F // all inputs
+
+/* Clock */
+#define ADC_CAPTURE_CLK_HZ 48000000 // clk_adc
+#define ADC_CAPTURE_CLKDIV_MIN 95   // one conversion takes 96 clk_adc cycles (500kS/s)
+
+/* DMA IRQ */
+#define ADC_CAPTURE_DMA_IRQ DMA_IRQ_0
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Capture */
+/*! \brief Initialize ADC capture
+ *  \ingroup adc_capture
+ *
+ * Initialize the ADC input, set up the ADC FIFO with DREQ enabled and claim two DMA channels.
+ * Each channel fills one half of the ping-pong buffer and chains to the other,
+ * so the capture keeps running while a completed frame is processed.
+ *
+ * \param adc_num ADC input number (0 ~ 3, GPIO 26 ~ 29)
+ * \param clkdiv ADC clock divider (48MHz / (1 + clkdiv) samples per second)
+ */
+void adc_capture_initialize(uint8_t adc_num, float clkdiv);
+
+/*! \brief Configure ADC capture
+ *  \ingroup adc_capture
+ *
+ * Change the sample rate and the frame size. Only call while capture is stopped.
+ *
+ * \param clkdiv ADC clock divider (48MHz / (1 + clkdiv) samples per second)
+ * \param frame_samples Samples per frame (1 ~ ADC_CAPTURE_FRAME_SAMPLES_MAX)
+ */
+void adc_capture_configure(float clkdiv, uint16_t frame_samples);
+
+/*! \brief Select ADC inputs
+ *  \ingroup adc_capture
+ *
+ * Select one input, or several inputs converted in round-robin order from the lowest.
+ * Frames then hold interleaved samples, lowest input first, and the frame size should be
+ * a multiple of the input count. Only call while capture is stopped.
+ *
+ * \param input_mask Bit n selects ADC input n
+ * \return Number of inputs selected
+ */
+uint8_t adc_capture_set_inputs(uint8_t input_mask);
+
+/*! \brief Get frame size
+ *  \ingroup adc_capture
+ *
+ * \param none
+ * \return Samples per frame
+ */
+uint16_t adc_capture_get_frame_samples(void);
+
+/*! \brief Start ADC capture
+ *  \ingroup adc_capture
+ *
+ * Drain the ADC FIFO, arm the first DMA channel and start free-running conversion.
+ *
+ * \param none
+ */
+void adc_capture_start(void);
+
+/*! \brief Stop ADC capture
+ *  \ingroup adc_capture
+ *
+ * Stop conversion, abort both DMA channels and drop any pending frames.
+ *
+ * \param none
+ */
+void adc_capture_stop(void);
+
+/*! \brief Get a completed frame
+ *  \ingroup adc_capture
+ *
+ * Return the oldest completed frame in capture order.
+ * Raw ADC words are 12-bit samples with the ERR flag in bit 15.
+ * The frame must be returned with adc_capture_release_frame() before the
+ * other half of the ping-pong buffer completes.
+ *
+ * \param none
+ * \return Pointer to adc_capture_get_frame_samples() raw samples, NULL if no frame is ready
+ */
+uint16_t *adc_capture_get_frame(void);
+
+/*! \brief Release a frame
+ *  \ingroup adc_capture
+ *
+ * Release the frame returned by adc_capture_get_frame().
+ *
+ * \param none
+ */
+void adc_capture_release_frame(void);
+
+/*! \brief Get frame timestamp
+ *  \ingroup adc_capture
+ *
+ * Only valid between adc_capture_get_frame() and adc_capture_release_frame().
+ *
+ * \param none
+ * \return time_us_64() taken in the DMA completion interrupt of the current frame
+ */
+uint64_t adc_capture_get_frame_time(void);
+
+/*! \brief Get frame sample index
+ *  \ingroup adc_capture
+ *
+ * Only valid between adc_capture_get_frame() and adc_capture_release_frame().
+ * Frames lost to an overrun still advance the index, so a gap shows up downstream.
+ *
+ * \param none
+ * \return Index of the first sample of the current frame since adc_capture_start()
+ */
+uint64_t adc_capture_get_frame_index(void);
+
+/*! \brief Get overrun count
+ *  \ingroup adc_capture
+ *
+ * Number of frames that were completed again before the previous contents were released.
+ *
+ * \param none
+ * \return Overrun count since adc_capture_start()
+ */
+uint32_t adc_capture_get_overrun(void);
+
+#endif /* _ADC_CAPTURE_H_ */
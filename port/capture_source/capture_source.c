@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stddef.h>
+
+#include "adc_capture.h"
+#include "pio_capture.h"
+#include "decimator.h"
+
+#include "capture_source.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* PIO */
+static bool g_capture_source_pio_init = false;
+static uint8_t g_capture_source_i2s_channels = 2;
+
+/* PDM */
+static decimator_pdm_t g_capture_source_pdm;
+static int32_t g_capture_source_pdm_pcm[PIO_CAPTURE_FRAME_WORDS_MAX * 32 / DECIMATOR_PDM_FACTOR];
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* ADC */
+static uint32_t capture_source_adc_configure(const capture_source_config_t *config)
+{
+    adc_capture_set_inputs((1u << config->channels) - 1);
+    adc_capture_configure(config->clkdiv, config->capture_samples);
+
+    return config->sample_rate;
+}
+
+static const void *capture_source_adc_get_frame(uint32_t *count)
+{
+    uint16_t *frame;
+
+    if ((frame = adc_capture_get_frame()) != NULL)
+        *count = adc_capture_get_frame_samples();
+
+    return frame;
+}
+
+/* PIO, shared by I2S and PDM */
+static void capture_source_pio_initialize(void)
+{
+    if (g_capture_source_pio_init)
+        return;
+
+    pio_capture_initialize();
+    g_capture_source_pio_init = true;
+}
+
+/* I2S */
+static uint32_t capture_source_i2s_configure(const capture_source_config_t *config)
+{
+    g_capture_source_i2s_channels = (config->channels == 1) ? 1 : 2;
+
+    return pio_capture_configure(PIO_CAPTURE_MODE_I2S, config->sample_rate, config->capture_samples);
+}
+
+static const void *capture_source_i2s_get_frame(uint32_t *count)
+{
+    uint32_t *frame;
+    uint32_t words;
+    uint32_t i;
+
+    if ((frame = pio_capture_get_frame()) == NULL)
+        return NULL;
+
+    words = pio_capture_get_frame_words();
+
+    /* Mono keeps the left slot, compact it in place */
+    if (g_capture_source_i2s_channels == 1)
+    {
+        for (i = 0; i < words / 2; i++)
+            frame[i] = frame[i * 2];
+
+        words /= 2;
+    }
+
+    *count = words;
+
+    return frame;
+}
+
+static uint64_t capture_source_i2s_get_frame_index(void)
+{
+    return (pio_capture_get_frame_index() * g_capture_source_i2s_channels) / 2;
+}
+
+/* PDM */
+static uint32_t capture_source_pdm_configure(const capture_source_config_t *config)
+{
+    decimator_pdm_init(&g_capture_source_pdm);
+
+    return pio_capture_configure(PIO_CAPTURE_MODE_PDM, config->sample_rate, config->capture_samples);
+}
+
+static const void *capture_source_pdm_get_frame(uint32_t *count)
+{
+    uint32_t *frame;
+
+    if ((frame = pio_capture_get_frame()) == NULL)
+        return NULL;
+
+    /* CIC runs here, on the core that consumes the frame */
+    *count = decimator_pdm_process(&g_capture_source_pdm, frame, pio_capture_get_frame_words(), g_capture_source_pdm_pcm);
+
+    return g_capture_source_pdm_pcm;
+}
+
+static uint64_t capture_source_pdm_get_frame_index(void)
+{
+    return (pio_capture_get_frame_index() * 32) / DECIMATOR_PDM_FACTOR;
+}
+
+/* Table, indexed by CAPTURE_SOURCE_xxx */
+static const capture_source_t g_capture_source[CAPTURE_SOURCE_MAX + 1] =
+{
+    {
+        .type = CAPTURE_SOURCE_TYPE_ADC12,
+        .initialize = NULL,
+        .configure = capture_source_adc_configure,
+        .start = adc_capture_start,
+        .stop = adc_capture_stop,
+        .get_frame = capture_source_adc_get_frame,
+        .release_frame = adc_capture_release_frame,
+        .get_frame_time = adc_capture_get_frame_time,
+        .get_frame_index = adc_capture_get_frame_index,
+        .get_overrun = adc_capture_get_overrun,
+    },
+    {
+        .type = CAPTURE_SOURCE_TYPE_S32,
+        .initialize = capture_source_pio_initialize,
+        .configure = capture_source_i2s_configure,
+        .start = pio_capture_start,
+        .stop = pio_capture_stop,
+        .get_frame = capture_source_i2s_get_frame,
+        .release_frame = pio_capture_release_frame,
+        .get_frame_time = pio_capture_get_frame_time,
+        .get_frame_index = capture_source_i2s_get_frame_index,
+        .get_overrun = pio_capture_get_overrun,
+    },
+    {
+        .type = CAPTURE_SOURCE_TYPE_S32,
+        .initialize = capture_source_pio_initialize,
+        .configure = capture_source_pdm_configure,
+        .start = pio_capture_start,
+        .stop = pio_capture_stop,
+        .get_frame = capture_source_pdm_get_frame,
+        .release_frame = pio_capture_release_frame,
+        .get_frame_time = pio_capture_get_frame_time,
+        .get_frame_index = capture_source_pdm_get_frame_index,
+        .get_overrun = pio_capture_get_overrun,
+    },
+};
+
+const capture_source_t *capture_source_open(uint8_t id)
+{
+    if (id > CAPTURE_SOURCE_MAX)
+        return NULL;
+
+    if (g_capture_source[id].initialize != NULL)
+        g_capture_source[id].initialize();
+
+    return &g_capture_source[id];
+}
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _CAPTURE_SOURCE_H_
+#define _CAPTURE_SOURCE_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Source */
+#define CAPTURE_SOURCE_ADC 0 // analog microphone on the RP2040 ADC
+#define CAPTURE_SOURCE_I2S 1 // I2S microphone on PIO
+#define CAPTURE_SOURCE_PDM 2 // PDM microphone on PIO
+#define CAPTURE_SOURCE_MAX 2
+
+/* Sample type */
+#define CAPTURE_SOURCE_TYPE_ADC12 0 // raw 12-bit ADC words with the ERR flag in bit 15
+#define CAPTURE_SOURCE_TYPE_S32 1   // left-justified signed 32-bit PCM
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+typedef struct capture_source_config_t
+{
+    uint32_t sample_rate;     // samples per second per channel
+    float clkdiv;             // ADC clock divider, ADC only
+    uint16_t capture_samples; // DMA frame elements
+    uint8_t channels;         // channels per sample group
+} capture_source_config_t;
+
+typedef struct capture_source_t
+{
+    uint8_t type;                                                  // CAPTURE_SOURCE_TYPE_xxx
+    void (*initialize)(void);                                      // NULL if set up elsewhere
+    uint32_t (*configure)(const capture_source_config_t *config);  // returns samples per second per channel
+    void (*start)(void);
+    void (*stop)(void);
+    const void *(*get_frame)(uint32_t *count);                     // count is samples of all channels, interleaved, once per frame
+    void (*release_frame)(void);
+    uint64_t (*get_frame_time)(void);                              // DMA completion time in us
+    uint64_t (*get_frame_index)(void);                             // first sample since start, all channels
+    uint32_t (*get_overrun)(void);
+} capture_source_t;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Source */
+/*! \brief Open a capture source
+ *  \ingroup capture_source
+ *
+ * Return the backend for a source and initialize it on first use. Every backend fills
+ * ping-pong frames by DMA and has the same frame, timestamp and overrun semantics as adc_capture.
+ * The ADC backend is expected to be initialized with adc_capture_initialize().
+ *
+ * \param id CAPTURE_SOURCE_xxx
+ * \return Capture source, NULL if the id is unknown
+ */
+const capture_source_t *capture_source_open(uint8_t id);
+
+#endif /* _CAPTURE_SOURCE_H_ */
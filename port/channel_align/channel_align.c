@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <string.h>
+
+#include "channel_align.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Raw ADC word */
+#define CHANNEL_ALIGN_ADC_MASK 0x0FFF
+#define CHANNEL_ALIGN_ADC_ERR 0x8000
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+void channel_align_init(channel_align_t *align, uint8_t channels)
+{
+    uint8_t i;
+
+    memset(align, 0, sizeof(channel_align_t));
+
+    if (channels == 0)
+        channels = 1;
+    else if (channels > CHANNEL_ALIGN_CHANNELS_MAX)
+        channels = CHANNEL_ALIGN_CHANNELS_MAX;
+
+    align->channels = channels;
+
+    for (i = 0; i < channels; i++)
+        align->weight[i] = (uint16_t)((256 * i) / channels);
+}
+
+void channel_align_process(channel_align_t *align, uint16_t *raw, uint32_t count)
+{
+    uint32_t i;
+    uint8_t ch = 0;
+    uint16_t word;
+    uint32_t cur;
+    uint32_t prev;
+
+    if (align->channels < 2)
+        return;
+
+    /* First group of a stream has no history, hold it */
+    if (!align->primed)
+    {
+        for (i = 0; (i < align->channels) && (i < count); i++)
+            align->prev[i] = raw[i];
+
+        align->primed = 1;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        word = raw[i];
+
+        if (align->weight[ch] != 0)
+        {
+            cur = word & CHANNEL_ALIGN_ADC_MASK;
+            prev = align->prev[ch] & CHANNEL_ALIGN_ADC_MASK;
+            cur = ((cur * (256 - align->weight[ch])) + (prev * align->weight[ch]) + 128) >> 8;
+
+            raw[i] = (uint16_t)cur | ((word | align->prev[ch]) & CHANNEL_ALIGN_ADC_ERR);
+        }
+
+        align->prev[ch] = word;
+
+        if (++ch >= align->channels)
+            ch = 0;
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _CHANNEL_ALIGN_H_
+#define _CHANNEL_ALIGN_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Channel */
+#define CHANNEL_ALIGN_CHANNELS_MAX 4 // ADC inputs 0 ~ 3
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+typedef struct channel_align_t
+{
+    uint8_t channels;                             // interleaved channels, 1 ~ CHANNEL_ALIGN_CHANNELS_MAX
+    uint16_t weight[CHANNEL_ALIGN_CHANNELS_MAX];  // Q8 weight of the previous sample per channel
+    uint16_t prev[CHANNEL_ALIGN_CHANNELS_MAX];    // last raw word per channel
+    uint8_t primed;                               // prev holds a real sample
+} channel_align_t;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Align */
+/*! \brief Initialize channel alignment
+ *  \ingroup channel_align
+ *
+ * \param align Channel alignment
+ * \param channels Interleaved channels (1 ~ CHANNEL_ALIGN_CHANNELS_MAX)
+ */
+void channel_align_init(channel_align_t *align, uint8_t channels);
+
+/*! \brief Align round-robin samples
+ *  \ingroup channel_align
+ *
+ * In ADC round-robin mode channel k of each group is converted k / channels of a sample period
+ * after channel 0. Move every channel back onto the channel 0 sampling instant by linear
+ * interpolation with its previous sample. Works in place on raw ADC words, the ERR bit is kept.
+ *
+ * \param align Channel alignment
+ * \param raw Interleaved raw ADC words, starting with channel 0
+ * \param count Number of words, a multiple of the channel count
+ */
+void channel_align_process(channel_align_t *align, uint16_t *raw, uint32_t count);
+
+#endif /* _CHANNEL_ALIGN_H_ */
@@ -0,0 +1,195 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <string.h>
+
+#include "decimator.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* CIC gain is DECIMATOR_CIC_FACTOR ^ DECIMATOR_CIC_ORDER = 2^12.
+ * Remove it but keep 3 fractional bits so the FIR input spans int15,
+ * the folded window x sum of |coefficients| then fits the 32-bit accumulator.
+ */
+#define DECIMATOR_CIC_SHIFT (12 - 3)
+
+/* Q15 coefficients, one bit less shift restores the 16-bit output */
+#define DECIMATOR_FIR_SHIFT (15 - 1)
+
+/* PDM CIC gain is 64^4 = 2^24, output spans -2^24 ~ 2^24 */
+#define DECIMATOR_PDM_MAX ((1 << 24) - 1)
+#define DECIMATOR_PDM_SHIFT 7 // to 32-bit left-justified
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Weighted least-squares FIR at 2 x output rate, Q15, DC gain 1.
+ * Passband 0 ~ 0.4 fs_out with CIC droop compensation (flat within 0.1dB together with the CIC),
+ * below -70dB from 0.5 fs_out so nothing folds back across the output Nyquist.
+ * Checked by rp_program/decimator_test.c.
+ */
+static const int16_t g_decimator_fir[DECIMATOR_FIR_TAPS] =
+{
+       -3,     -6,      0,     14,     11,    -16,    -28,      8,
+       49,     14,    -65,    -54,     66,    107,    -41,   -167,
+      -20,    215,    123,   -230,   -262,    187,    420,    -61,
+     -566,   -162,    656,    484,   -634,   -891,    438,   1345,
+        8,  -1783,   -810,   2104,   2181,  -2077,  -4755,    651,
+    11426,  17016,  11426,    651,  -4755,  -2077,   2181,   2104,
+     -810,  -1783,      8,   1345,    438,   -891,   -634,    484,
+      656,   -162,   -566,    -61,    420,    187,   -262,   -230,
+      123,    215,    -20,   -167,    -41,    107,     66,    -54,
+      -65,     14,     49,      8,    -28,    -16,     11,     14,
+        0,     -6,     -3,
+};
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+static inline int16_t decimator_fir(const decimator_t *dec)
+{
+    const int16_t *x = &dec->history[dec->pos];
+    int32_t acc;
+    uint32_t i;
+
+    /* Symmetric taps, fold the window to halve the multiplies */
+    acc = (int32_t)g_decimator_fir[DECIMATOR_FIR_TAPS / 2] * x[DECIMATOR_FIR_TAPS / 2];
+
+    for (i = 0; i < DECIMATOR_FIR_TAPS / 2; i++)
+        acc += (int32_t)g_decimator_fir[i] * ((int32_t)x[i] + x[DECIMATOR_FIR_TAPS - 1 - i]);
+
+    acc = (acc + (1 << (DECIMATOR_FIR_SHIFT - 1))) >> DECIMATOR_FIR_SHIFT;
+
+    if (acc > INT16_MAX)
+        acc = INT16_MAX;
+    else if (acc < INT16_MIN)
+        acc = INT16_MIN;
+
+    return (int16_t)acc;
+}
+
+void decimator_init(decimator_t *dec)
+{
+    memset(dec, 0, sizeof(decimator_t));
+}
+
+uint32_t decimator_process(decimator_t *dec, const uint16_t *in, uint32_t in_count, int16_t *out)
+{
+    uint32_t out_count = 0;
+    uint32_t value;
+    uint32_t prev;
+    uint32_t i;
+    uint8_t j;
+
+    for (i = 0; i < in_count; i++)
+    {
+        /* Integrators, modulo 2^32 arithmetic is exact for a CIC */
+        value = (uint32_t)((int32_t)(in[i] & 0x0FFF) - 2048);
+
+        for (j = 0; j < DECIMATOR_CIC_ORDER; j++)
+        {
+            dec->integrator[j] += value;
+            value = dec->integrator[j];
+        }
+
+        if (++dec->cic_phase < DECIMATOR_CIC_FACTOR)
+            continue;
+
+        dec->cic_phase = 0;
+
+        /* Combs at the intermediate rate */
+        for (j = 0; j < DECIMATOR_CIC_ORDER; j++)
+        {
+            prev = dec->comb[j];
+            dec->comb[j] = value;
+            value -= prev;
+        }
+
+        /* Push into the FIR delay line */
+        if (dec->pos == 0)
+            dec->pos = DECIMATOR_FIR_TAPS;
+
+        dec->pos--;
+        dec->history[dec->pos] = (int16_t)(((int32_t)value + (1 << (DECIMATOR_CIC_SHIFT - 1))) >> DECIMATOR_CIC_SHIFT);
+        dec->history[dec->pos + DECIMATOR_FIR_TAPS] = dec->history[dec->pos];
+
+        if (++dec->fir_phase < DECIMATOR_FIR_FACTOR)
+            continue;
+
+        dec->fir_phase = 0;
+        out[out_count++] = decimator_fir(dec);
+    }
+
+    return out_count;
+}
+
+void decimator_pdm_init(decimator_pdm_t *dec)
+{
+    memset(dec, 0, sizeof(decimator_pdm_t));
+}
+
+uint32_t decimator_pdm_process(decimator_pdm_t *dec, const uint32_t *bits, uint32_t word_count, int32_t *out)
+{
+    uint32_t out_count = 0;
+    uint32_t word;
+    uint32_t value;
+    uint32_t prev;
+    int32_t pcm;
+    uint32_t i;
+    uint8_t b;
+    uint8_t j;
+
+    for (i = 0; i < word_count; i++)
+    {
+        word = bits[i];
+
+        /* Integrators at the bit rate, a 1 is +1 and a 0 is -1 */
+        for (b = 0; b < 32; b++)
+        {
+            dec->integrator[0] += (word & 0x80000000) ? 1 : (uint32_t)-1;
+            dec->integrator[1] += dec->integrator[0];
+            dec->integrator[2] += dec->integrator[1];
+            dec->integrator[3] += dec->integrator[2];
+            word <<= 1;
+        }
+
+        if (((i + 1) % (DECIMATOR_PDM_FACTOR / 32)) != 0)
+            continue;
+
+        /* Combs at the PCM rate */
+        value = dec->integrator[DECIMATOR_PDM_ORDER - 1];
+
+        for (j = 0; j < DECIMATOR_PDM_ORDER; j++)
+        {
+            prev = dec->comb[j];
+            dec->comb[j] = value;
+            value -= prev;
+        }
+
+        pcm = (int32_t)value;
+
+        if (pcm > DECIMATOR_PDM_MAX)
+            pcm = DECIMATOR_PDM_MAX;
+        else if (pcm < -DECIMATOR_PDM_MAX)
+            pcm = -DECIMATOR_PDM_MAX;
+
+        out[out_count++] = pcm << DECIMATOR_PDM_SHIFT;
+    }
+
+    return out_count;
+}
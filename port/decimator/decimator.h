@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _DECIMATOR_H_
+#define _DECIMATOR_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* CIC */
+#define DECIMATOR_CIC_ORDER 6 // what folds from around 2 x fs_out stays below -65dB
+#define DECIMATOR_CIC_FACTOR 4
+
+/* FIR */
+#define DECIMATOR_FIR_FACTOR 2
+#define DECIMATOR_FIR_TAPS 83 // odd, symmetric
+
+/* Total */
+#define DECIMATOR_FACTOR (DECIMATOR_CIC_FACTOR * DECIMATOR_FIR_FACTOR)
+
+/* PDM */
+#define DECIMATOR_PDM_ORDER 4
+#define DECIMATOR_PDM_FACTOR 64 // PDM bits per PCM sample, 32-bit words must hold whole samples
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+typedef struct decimator_t
+{
+    /* CIC */
+    uint32_t integrator[DECIMATOR_CIC_ORDER];
+    uint32_t comb[DECIMATOR_CIC_ORDER];
+    uint8_t cic_phase;
+
+    /* FIR, delay line is stored twice so a window never wraps */
+    int16_t history[DECIMATOR_FIR_TAPS * 2];
+    uint8_t pos;
+    uint8_t fir_phase;
+} decimator_t;
+
+typedef struct decimator_pdm_t
+{
+    uint32_t integrator[DECIMATOR_PDM_ORDER];
+    uint32_t comb[DECIMATOR_PDM_ORDER];
+} decimator_pdm_t;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Decimator */
+/*! \brief Initialize decimator
+ *  \ingroup decimator
+ *
+ * Clear the filter state.
+ *
+ * \param dec Decimator
+ */
+void decimator_init(decimator_t *dec);
+
+/*! \brief Decimate raw ADC samples
+ *  \ingroup decimator
+ *
+ * Decimate raw 12-bit ADC words by DECIMATOR_FACTOR with a CIC stage followed by a
+ * droop-compensating half-band-rate FIR. Samples are centered on mid-scale (2048)
+ * and the output is scaled to the full 16-bit range.
+ *
+ * \param dec Decimator
+ * \param in Raw ADC words, the ERR bit is ignored
+ * \param in_count Number of input words
+ * \param out Output buffer, room for in_count / DECIMATOR_FACTOR + 1 samples
+ * \return Number of output samples written
+ */
+uint32_t decimator_process(decimator_t *dec, const uint16_t *in, uint32_t in_count, int16_t *out);
+
+/* PDM */
+/*! \brief Initialize PDM decimator
+ *  \ingroup decimator
+ *
+ * \param dec PDM decimator
+ */
+void decimator_pdm_init(decimator_pdm_t *dec);
+
+/*! \brief Decimate a PDM bitstream
+ *  \ingroup decimator
+ *
+ * Decimate a 1-bit PDM stream by DECIMATOR_PDM_FACTOR with a CIC filter of order DECIMATOR_PDM_ORDER.
+ * The CIC output has 25 significant bits and is returned left-justified in 32 bits.
+ *
+ * \param dec PDM decimator
+ * \param bits PDM words, oldest bit in the MSB
+ * \param word_count Number of words, a multiple of DECIMATOR_PDM_FACTOR / 32
+ * \param out Output buffer, room for word_count * 32 / DECIMATOR_PDM_FACTOR samples
+ * \return Number of output samples written
+ */
+uint32_t decimator_pdm_process(decimator_pdm_t *dec, const uint32_t *bits, uint32_t word_count, int32_t *out);
+
+#endif /* _DECIMATOR_H_ */
@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <string.h>
+
+#include "fec.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+static void fec_xor(uint8_t *parity, const uint8_t *data, uint16_t len)
+{
+    uint32_t *dst = (uint32_t *)parity;
+    const uint32_t *src = (const uint32_t *)data;
+    uint16_t words = len / 4;
+    uint16_t i;
+
+    for (i = 0; i < words; i++)
+        dst[i] ^= src[i];
+
+    for (i = words * 4; i < len; i++)
+        parity[i] ^= data[i];
+}
+
+static void fec_put_header(fec_t *fec)
+{
+    uint8_t *p = fec->buf;
+    uint8_t i;
+
+    p[0] = 'F';
+    p[1] = 'E';
+    p[2] = 'C';
+    p[3] = fec->group;
+
+    for (i = 0; i < 8; i++)
+    {
+        p[4 + i] = (uint8_t)(fec->first_index >> (56 - (i * 8)));
+        p[12 + i] = (uint8_t)(fec->last_index >> (56 - (i * 8)));
+    }
+
+    p[20] = (uint8_t)(fec->len_xor >> 8);
+    p[21] = (uint8_t)fec->len_xor;
+    p[22] = (uint8_t)(fec->len >> 8);
+    p[23] = (uint8_t)fec->len;
+}
+
+void fec_init(fec_t *fec, uint8_t group)
+{
+    if ((group < FEC_GROUP_MIN) || (group > FEC_GROUP_MAX))
+        group = 0;
+
+    fec->group = group;
+    fec->count = 0;
+    fec->len = 0;
+    fec->len_xor = 0;
+}
+
+uint16_t fec_add(fec_t *fec, const uint8_t *data, uint16_t len, uint64_t index, uint8_t **packet)
+{
+    uint8_t *parity = fec->buf + FEC_HEADER_SIZE;
+
+    if ((fec->group == 0) || (len > FEC_PAYLOAD_MAX))
+        return 0;
+
+    /* Shorter datagrams count as zero padded up to the parity length */
+    if (fec->count == 0)
+    {
+        memcpy(parity, data, len);
+        fec->len = len;
+        fec->len_xor = len;
+        fec->first_index = index;
+    }
+    else
+    {
+        if (len > fec->len)
+        {
+            memset(parity + fec->len, 0, len - fec->len);
+            fec->len = len;
+        }
+
+        fec_xor(parity, data, len);
+        fec->len_xor ^= len;
+    }
+
+    fec->last_index = index;
+
+    if (++fec->count < fec->group)
+        return 0;
+
+    fec_put_header(fec);
+    fec->count = 0;
+    *packet = fec->buf;
+
+    return FEC_HEADER_SIZE + fec->len;
+}
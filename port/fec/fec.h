@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _FEC_H_
+#define _FEC_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+
+#include "frame_pool.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Group */
+#define FEC_GROUP_MIN 2
+#define FEC_GROUP_MAX 16
+
+/* Parity packet header, big endian
+ *  0 : 'F' 'E' 'C' <group>
+ *  4 : sample index of the first protected packet
+ * 12 : sample index of the last protected packet
+ * 20 : XOR of the protected datagram lengths
+ * 22 : parity length, the longest protected datagram
+ * 24 : parity
+ */
+#define FEC_HEADER_SIZE 24
+#define FEC_PAYLOAD_MAX (FRAME_POOL_HEADROOM + FRAME_POOL_FRAME_SIZE)
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+typedef struct fec_t
+{
+    uint8_t group;        // data packets per parity packet, 0 for off
+    uint8_t count;        // data packets in the parity so far
+    uint16_t len;         // parity length
+    uint16_t len_xor;     // XOR of the protected lengths
+    uint64_t first_index; // sample index of the first protected packet
+    uint64_t last_index;  // sample index of the last protected packet
+    uint8_t buf[FEC_HEADER_SIZE + FEC_PAYLOAD_MAX] __attribute__((aligned(4)));
+} fec_t;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* FEC */
+/*! \brief Initialize XOR parity
+ *  \ingroup fec
+ *
+ * \param fec FEC state
+ * \param group Data packets per parity packet (FEC_GROUP_MIN ~ FEC_GROUP_MAX), 0 for off
+ */
+void fec_init(fec_t *fec, uint8_t group);
+
+/*! \brief Protect a data packet
+ *  \ingroup fec
+ *
+ * XOR a sent datagram into the running parity, in the style of RFC 5109 ULPFEC level 0.
+ * Once group packets are in, the parity packet is returned for sending and the next
+ * group starts. Any one lost datagram of a group can be rebuilt from the others and the
+ * parity, including its timing header.
+ *
+ * \param fec FEC state
+ * \param data Datagram as sent, 4-byte aligned
+ * \param len Datagram length, up to FEC_PAYLOAD_MAX
+ * \param index Sample index of the packet
+ * \param packet Set to the parity packet when one is complete
+ * \return Parity packet length, 0 while the group is not complete
+ */
+uint16_t fec_add(fec_t *fec, const uint8_t *data, uint16_t len, uint64_t index, uint8_t **packet);
+
+#endif /* _FEC_H_ */
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stddef.h>
+
+#include "pico/stdlib.h"
+#include "pico/critical_section.h"
+
+#include "frame_pool.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* A header built in head[] is sent together with data in one buffer */
+_Static_assert(offsetof(frame_t, data) == offsetof(frame_t, head) + FRAME_POOL_HEADROOM, "frame head must be contiguous with data");
+
+/* Pool */
+static frame_t g_frame_pool[FRAME_POOL_FRAME_COUNT];
+static frame_t *g_frame_pool_free = NULL;
+static critical_section_t g_frame_pool_cri_sec;
+static bool g_frame_pool_cri_sec_init = false;
+
+/* Statistics */
+static uint32_t g_frame_pool_used = 0;
+static uint32_t g_frame_pool_high_water = 0;
+static uint32_t g_frame_pool_fail = 0;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+void frame_pool_initialize(void)
+{
+    uint32_t i;
+
+    if (!g_frame_pool_cri_sec_init)
+    {
+        critical_section_init(&g_frame_pool_cri_sec);
+        g_frame_pool_cri_sec_init = true;
+    }
+
+    g_frame_pool_free = NULL;
+
+    for (i = 0; i < FRAME_POOL_FRAME_COUNT; i++)
+    {
+        g_frame_pool[i].next = g_frame_pool_free;
+        g_frame_pool_free = &g_frame_pool[i];
+    }
+
+    g_frame_pool_used = 0;
+    g_frame_pool_high_water = 0;
+    g_frame_pool_fail = 0;
+}
+
+frame_t *frame_pool_take(void)
+{
+    frame_t *frame;
+
+    critical_section_enter_blocking(&g_frame_pool_cri_sec);
+
+    frame = g_frame_pool_free;
+
+    if (frame != NULL)
+    {
+        g_frame_pool_free = frame->next;
+
+        if (++g_frame_pool_used > g_frame_pool_high_water)
+            g_frame_pool_high_water = g_frame_pool_used;
+    }
+    else
+    {
+        g_frame_pool_fail++;
+    }
+
+    critical_section_exit(&g_frame_pool_cri_sec);
+
+    if (frame != NULL)
+    {
+        frame->next = NULL;
+        frame->len = 0;
+    }
+
+    return frame;
+}
+
+void frame_pool_give(frame_t *frame)
+{
+    if (frame == NULL)
+        return;
+
+    critical_section_enter_blocking(&g_frame_pool_cri_sec);
+
+    frame->next = g_frame_pool_free;
+    g_frame_pool_free = frame;
+    g_frame_pool_used--;
+
+    critical_section_exit(&g_frame_pool_cri_sec);
+}
+
+uint32_t frame_pool_get_used(void)
+{
+    return g_frame_pool_used;
+}
+
+uint32_t frame_pool_get_high_water(void)
+{
+    return g_frame_pool_high_water;
+}
+
+uint32_t frame_pool_get_fail(void)
+{
+    return g_frame_pool_fail;
+}
@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _FRAME_POOL_H_
+#define _FRAME_POOL_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Pool */
+#define FRAME_POOL_FRAME_SIZE 1472 // payload bytes per frame, one UDP datagram in a 1500-byte MTU
+#define FRAME_POOL_QUEUE_FRAMES 32 // filled by the capture or waiting to be sent, split evenly by a per-session queue limit
+#define FRAME_POOL_RETX_FRAMES 24  // kept for retransmission, RETX_HISTORY_DEPTH of the one nack=1 session
+#define FRAME_POOL_SENT_FRAMES 3   // last frame of each session, may still be read by the SPI DMA
+#define FRAME_POOL_FRAME_COUNT (FRAME_POOL_QUEUE_FRAMES + FRAME_POOL_RETX_FRAMES + FRAME_POOL_SENT_FRAMES) // frames in the pool
+#define FRAME_POOL_HEADROOM 16    // bytes reserved in front of data for a protocol header
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+typedef struct frame_t
+{
+    struct frame_t *next;   // free list link, owned by the pool
+    uint16_t len;           // valid bytes in data
+    uint64_t timestamp_us;  // capture time of the DMA frame holding the first sample
+    uint64_t sample_index;  // index of the first sample since the stream started
+    uint64_t sync_index;    // index just past the last sample of that DMA frame, captured at timestamp_us
+    uint8_t head[FRAME_POOL_HEADROOM] __attribute__((aligned(4))); // protocol header, directly in front of data
+    uint8_t data[FRAME_POOL_FRAME_SIZE];
+} frame_t;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Pool */
+/*! \brief Initialize frame pool
+ *  \ingroup frame_pool
+ *
+ * Put every frame on the free list and clear the statistics.
+ * The pool is shared by both cores and is protected by a critical section.
+ *
+ * \param none
+ */
+void frame_pool_initialize(void);
+
+/*! \brief Take a frame
+ *  \ingroup frame_pool
+ *
+ * Take a free frame in O(1). Never blocks.
+ *
+ * \param none
+ * \return Frame with len set to 0, NULL if the pool is exhausted
+ */
+frame_t *frame_pool_take(void);
+
+/*! \brief Give a frame back
+ *  \ingroup frame_pool
+ *
+ * Return a frame taken with frame_pool_take() in O(1).
+ *
+ * \param frame Frame to return
+ */
+void frame_pool_give(frame_t *frame);
+
+/*! \brief Get used frame count
+ *  \ingroup frame_pool
+ *
+ * \param none
+ * \return Number of frames currently taken
+ */
+uint32_t frame_pool_get_used(void);
+
+/*! \brief Get high-water mark
+ *  \ingroup frame_pool
+ *
+ * \param none
+ * \return Highest number of frames taken at once since frame_pool_initialize()
+ */
+uint32_t frame_pool_get_high_water(void);
+
+/*! \brief Get failure count
+ *  \ingroup frame_pool
+ *
+ * \param none
+ * \return Number of frame_pool_take() calls that found the pool empty
+ */
+uint32_t frame_pool_get_fail(void);
+
+#endif /* _FRAME_POOL_H_ */
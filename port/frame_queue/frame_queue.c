@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stddef.h>
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+#include "frame_queue.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+void frame_queue_init(frame_queue_t *q)
+{
+    q->head = 0;
+    q->tail = 0;
+    q->drop = 0;
+}
+
+bool frame_queue_push(frame_queue_t *q, void *frame)
+{
+    uint32_t head = q->head;
+
+    if (head - q->tail >= FRAME_QUEUE_DEPTH)
+    {
+        q->drop++;
+
+        return false;
+    }
+
+    q->entry[head & FRAME_QUEUE_MASK] = frame;
+
+    /* Entry must be visible to the other core before the new head */
+    __dmb();
+    q->head = head + 1;
+
+    return true;
+}
+
+void *frame_queue_pop(frame_queue_t *q)
+{
+    uint32_t tail = q->tail;
+    void *frame;
+
+    if (tail == q->head)
+        return NULL;
+
+    __dmb();
+    frame = q->entry[tail & FRAME_QUEUE_MASK];
+    __dmb();
+    q->tail = tail + 1;
+
+    return frame;
+}
+
+uint32_t frame_queue_get_level(frame_queue_t *q)
+{
+    return q->head - q->tail;
+}
+
+uint32_t frame_queue_get_drop(frame_queue_t *q)
+{
+    return q->drop;
+}
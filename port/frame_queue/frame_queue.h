@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _FRAME_QUEUE_H_
+#define _FRAME_QUEUE_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Queue */
+#define FRAME_QUEUE_DEPTH 32 // must be a power of two
+#define FRAME_QUEUE_MASK (FRAME_QUEUE_DEPTH - 1)
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Single-producer/single-consumer ring of frame pointers.
+ * head is only written by the producer and tail only by the consumer,
+ * so one core can push while the other pops without a lock.
+ */
+typedef struct frame_queue_t
+{
+    void *entry[FRAME_QUEUE_DEPTH];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t drop;
+} frame_queue_t;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Queue */
+/*! \brief Initialize frame queue
+ *  \ingroup frame_queue
+ *
+ * Empty the queue and clear the drop counter.
+ *
+ * \param q Frame queue
+ */
+void frame_queue_init(frame_queue_t *q);
+
+/*! \brief Push a frame
+ *  \ingroup frame_queue
+ *
+ * Producer side. Never blocks, a full queue counts a drop instead.
+ *
+ * \param q Frame queue
+ * \param frame Frame pointer
+ * \return true if queued, false if the queue was full
+ */
+bool frame_queue_push(frame_queue_t *q, void *frame);
+
+/*! \brief Pop a frame
+ *  \ingroup frame_queue
+ *
+ * Consumer side. Never blocks.
+ *
+ * \param q Frame queue
+ * \return Oldest frame pointer, NULL if the queue is empty
+ */
+void *frame_queue_pop(frame_queue_t *q);
+
+/*! \brief Get queue level
+ *  \ingroup frame_queue
+ *
+ * \param q Frame queue
+ * \return Number of queued frames
+ */
+uint32_t frame_queue_get_level(frame_queue_t *q);
+
+/*! \brief Get drop count
+ *  \ingroup frame_queue
+ *
+ * \param q Frame queue
+ * \return Number of frames rejected because the queue was full
+ */
+uint32_t frame_queue_get_drop(frame_queue_t *q);
+
+#endif /* _FRAME_QUEUE_H_ */
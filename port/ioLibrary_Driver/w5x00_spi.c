@@ -10,12 +10,29 @@
   * ----------------------------------------------------------------------------------------------------
   */
 #include <stdio.h>
+#include <string.h>
+#include <stddef.h>
 
 #include "port_common.h"
 
 #include "wizchip_conf.h"
 #include "w5x00_spi.h"
 
+#ifdef USE_SPI_DMA
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#endif
+
+#ifdef USE_SPI_PIO
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "w5x00_spi.pio.h"
+#endif
+
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "pico/unique_id.h"
+
 /**
   * ----------------------------------------------------------------------------------------------------
   * Variables
@@ -23,11 +40,52 @@
   */
 static critical_section_t g_wizchip_cri_sec;
 
+/* SPI clock, SCK = clk_peri / (2 x divider), slowest first */
+static const uint8_t g_spi_tune_div[] = {13, 10, 8, 6, 5, 4, 3, 2, 1};
+static int8_t g_spi_tune_index = -1; // -1 before tuning, SPI at SPI_BAUD_DEFAULT
+static uint8_t g_spi_tune_pattern[SPI_TUNE_PATTERN_SIZE];
+static uint8_t g_spi_tune_readback[SPI_TUNE_PATTERN_SIZE];
+
+typedef struct spi_tune_record_t
+{
+    uint32_t magic;
+    uint32_t peri_hz;  // clk_peri the divider was tuned at
+    uint32_t div;      // SCK divider
+    uint8_t board_id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES];
+    uint32_t check;
+} spi_tune_record_t;
+
 #ifdef USE_SPI_DMA
 static uint dma_tx;
 static uint dma_rx;
 static dma_channel_config dma_channel_config_tx;
 static dma_channel_config dma_channel_config_rx;
+
+/* Gather write, dma_ctrl feeds {count, read address} pairs to dma_tx, which chains back to it */
+static uint dma_ctrl;
+static dma_channel_config dma_channel_config_ctrl;
+static dma_channel_config dma_channel_config_vec;
+static uint32_t g_dma_ctrl_block[(WIZ_IOVEC_MAX + 3) * 2];
+
+/* Asynchronous gather write, the chip stays selected until the RX channel drains */
+static volatile bool g_spi_async_busy = false;
+static uint8_t g_spi_async_dummy;
+#endif
+
+#ifdef USE_SPI_PIO
+/* PIO SPI, one command stream of {read address, write address, count, control} blocks per frame */
+static uint g_spi_pio_sm;
+static uint g_spi_pio_dma_tx;
+static uint g_spi_pio_dma_rx;
+static uint g_spi_pio_dma_ctrl;
+static uint32_t g_spi_pio_ctrl_header; // TX channel control, 32-bit header word
+static uint32_t g_spi_pio_ctrl_data;   // TX channel control, 8-bit pieces
+static uint32_t g_spi_pio_header;
+static uint32_t g_spi_pio_block[WIZ_IOVEC_MAX + 4][4]; // header, up to WIZ_IOVEC_MAX + 2 pieces, null block
+static uint32_t g_spi_pio_baudrate;
+
+/* Asynchronous frame, the program raises CS by itself at the end */
+static volatile bool g_spi_async_busy = false;
 #endif
 
 /**
@@ -121,11 +179,210 @@ static void wizchip_write_burst(uint8_t *pBuf, uint16_t len)
     dma_start_channel_mask((1u << dma_tx) | (1u << dma_rx));
     dma_channel_wait_for_finish_blocking(dma_rx);
 }
+
+// fill the control block and start the chain, return the bytes started
+static uint32_t wizchip_write_burst_vec_start(wiz_IOVec *vec, uint8_t cnt, uint8_t *dummy_data)
+{
+    uint32_t len = 0;
+    uint8_t block = 0;
+    uint8_t i;
+
+    for (i = 0; (i < cnt) && (block < WIZ_IOVEC_MAX + 2); i++)
+    {
+        if (vec[i].len == 0)
+            continue;
+
+        g_dma_ctrl_block[block * 2 + 0] = vec[i].len;
+        g_dma_ctrl_block[block * 2 + 1] = (uint32_t)vec[i].buf;
+        len += vec[i].len;
+        block++;
+    }
+
+    if (len == 0)
+        return 0;
+
+    // null trigger, stops the chain after the last piece
+    g_dma_ctrl_block[block * 2 + 0] = 0;
+    g_dma_ctrl_block[block * 2 + 1] = 0;
+
+    // the data channel only gets its write address and control here, each piece triggers it
+    dma_channel_configure(dma_tx, &dma_channel_config_vec,
+                          &spi_get_hw(SPI_PORT)->dr, // write address
+                          NULL,                      // read address, from the control block
+                          0,                         // element count, from the control block
+                          false);                    // don't start yet
+
+    channel_config_set_read_increment(&dma_channel_config_rx, false);
+    channel_config_set_write_increment(&dma_channel_config_rx, false);
+    dma_channel_configure(dma_rx, &dma_channel_config_rx,
+                          dummy_data,                // write address
+                          &spi_get_hw(SPI_PORT)->dr, // read address
+                          len,                       // all pieces
+                          true);                     // start, paced by the RX FIFO
+
+    dma_channel_configure(dma_ctrl, &dma_channel_config_ctrl,
+                          &dma_hw->ch[dma_tx].al3_transfer_count, // write address, count then read address trigger
+                          g_dma_ctrl_block,                       // read address
+                          2,                                      // one control block per trigger
+                          true);                                  // start
+
+    return len;
+}
+
+static void wizchip_write_burst_vec(wiz_IOVec *vec, uint8_t cnt)
+{
+    uint8_t dummy_data;
+
+    if (wizchip_write_burst_vec_start(vec, cnt, &dummy_data))
+        dma_channel_wait_for_finish_blocking(dma_rx);
+}
+
+static void wizchip_write_burst_vec_async(wiz_IOVec *vec, uint8_t cnt)
+{
+    // the RX channel raises SPI_DMA_IRQ only here, the blocking transfers leave it quiet
+    dma_channel_acknowledge_irq1(dma_rx);
+    dma_channel_set_irq1_enabled(dma_rx, true);
+
+    if (wizchip_write_burst_vec_start(vec, cnt, &g_spi_async_dummy))
+        g_spi_async_busy = true;
+    else
+        wizchip_deselect();
+}
+
+static void wizchip_spi_async_finish(void)
+{
+    if (!g_spi_async_busy)
+        return;
+
+    dma_channel_wait_for_finish_blocking(dma_rx);
+    dma_channel_set_irq1_enabled(dma_rx, false);
+    dma_channel_acknowledge_irq1(dma_rx);
+    wizchip_deselect();
+    g_spi_async_busy = false;
+}
+
+static void wizchip_spi_dma_handler(void)
+{
+    if (dma_channel_get_irq1_status(dma_rx))
+        wizchip_spi_async_finish();
+}
 #endif
 
+#ifdef USE_SPI_PIO
+static void wizchip_pio_frame_start(wiz_IOVec *tx, uint8_t cnt, uint8_t *rx, uint16_t rxlen)
+{
+    uint32_t len = 0;
+    uint8_t block = 1;
+    uint8_t i;
+
+    for (i = 0; (i < cnt) && (block < WIZ_IOVEC_MAX + 3); i++)
+    {
+        if (tx[i].len == 0)
+            continue;
+
+        g_spi_pio_block[block][0] = (uint32_t)tx[i].buf;
+        g_spi_pio_block[block][1] = (uint32_t)&SPI_PIO->txf[g_spi_pio_sm];
+        g_spi_pio_block[block][2] = tx[i].len;
+        g_spi_pio_block[block][3] = g_spi_pio_ctrl_data;
+        len += tx[i].len;
+        block++;
+    }
+
+    // null trigger, stops the stream after the last piece
+    memset(g_spi_pio_block[block], 0, sizeof(g_spi_pio_block[block]));
+
+    // the header goes first, it tells the program how long CS stays low
+    g_spi_pio_header = ((len * 8 - 1) << 16) | ((uint32_t)rxlen * 8);
+    g_spi_pio_block[0][0] = (uint32_t)&g_spi_pio_header;
+    g_spi_pio_block[0][1] = (uint32_t)&SPI_PIO->txf[g_spi_pio_sm];
+    g_spi_pio_block[0][2] = 1;
+    g_spi_pio_block[0][3] = g_spi_pio_ctrl_header;
+
+    pio_interrupt_clear(SPI_PIO, g_spi_pio_sm);
+    if (rxlen)
+        dma_channel_transfer_to_buffer_now(g_spi_pio_dma_rx, rx, rxlen);
+    dma_channel_set_read_addr(g_spi_pio_dma_ctrl, g_spi_pio_block, true);
+}
+
+static void wizchip_pio_frame_wait(void)
+{
+    // the program raises its IRQ flag once CS is high, the RX channel may still hold the last byte
+    while (!pio_interrupt_get(SPI_PIO, g_spi_pio_sm))
+        tight_loop_contents();
+    dma_channel_wait_for_finish_blocking(g_spi_pio_dma_rx);
+}
+
+static void wizchip_pio_frame(wiz_IOVec *tx, uint8_t cnt, uint8_t *rx, uint16_t rxlen)
+{
+    uint8_t cmd[3];
+    wiz_IOVec cmd_vec;
+    uint16_t addr;
+
+    // only reads can be that long, they have just the opcode and address to write
+    while (rxlen > SPI_PIO_READ_MAX)
+    {
+        wizchip_pio_frame_start(tx, cnt, rx, SPI_PIO_READ_MAX);
+        wizchip_pio_frame_wait();
+
+        addr = (((uint16_t)tx[0].buf[1] << 8) | tx[0].buf[2]) + SPI_PIO_READ_MAX;
+        cmd[0] = tx[0].buf[0];
+        cmd[1] = (uint8_t)(addr >> 8);
+        cmd[2] = (uint8_t)addr;
+        cmd_vec.buf = cmd;
+        cmd_vec.len = 3;
+        tx = &cmd_vec;
+        cnt = 1;
+        rx += SPI_PIO_READ_MAX;
+        rxlen -= SPI_PIO_READ_MAX;
+    }
+
+    wizchip_pio_frame_start(tx, cnt, rx, rxlen);
+    wizchip_pio_frame_wait();
+}
+
+static void wizchip_pio_frame_async(wiz_IOVec *vec, uint8_t cnt)
+{
+    wizchip_pio_frame_start(vec, cnt, NULL, 0);
+    g_spi_async_busy = true;
+}
+
+static void wizchip_spi_async_finish(void)
+{
+    if (!g_spi_async_busy)
+        return;
+
+    wizchip_pio_frame_wait();
+    g_spi_async_busy = false;
+}
+#endif
+
+bool wizchip_spi_busy(void)
+{
+#if defined(USE_SPI_DMA) || defined(USE_SPI_PIO)
+    return g_spi_async_busy;
+#else
+    return false;
+#endif
+}
+
+void wizchip_spi_wait(void)
+{
+#if defined(USE_SPI_DMA) || defined(USE_SPI_PIO)
+    uint32_t save;
+
+    save = save_and_disable_interrupts();
+    wizchip_spi_async_finish();
+    restore_interrupts(save);
+#endif
+}
+
 static void wizchip_critical_section_lock(void)
 {
     critical_section_enter_blocking(&g_wizchip_cri_sec);
+#if defined(USE_SPI_DMA) || defined(USE_SPI_PIO)
+    // an asynchronous write still holds the chip, finish it here as the IRQ is now masked
+    wizchip_spi_async_finish();
+#endif
 }
 
 static void wizchip_critical_section_unlock(void)
@@ -133,10 +390,83 @@ static void wizchip_critical_section_unlock(void)
     critical_section_exit(&g_wizchip_cri_sec);
 }
 
+static uint32_t wizchip_spi_set_baudrate(uint32_t baudrate)
+{
+#ifdef USE_SPI_PIO
+    // integer divider only, the nearest rate not above baudrate
+    uint32_t bit_hz = baudrate * SPI_PIO_CYCLES_PER_BIT;
+    uint32_t div = (clock_get_hz(clk_sys) + bit_hz - 1) / bit_hz;
+
+    if (div < 1)
+        div = 1;
+
+    pio_sm_set_clkdiv_int_frac(SPI_PIO, g_spi_pio_sm, div, 0);
+    g_spi_pio_baudrate = clock_get_hz(clk_sys) / (SPI_PIO_CYCLES_PER_BIT * div);
+
+    return g_spi_pio_baudrate;
+#else
+    return spi_set_baudrate(SPI_PORT, baudrate);
+#endif
+}
+
+static uint32_t wizchip_spi_get_baudrate(void)
+{
+#ifdef USE_SPI_PIO
+    return g_spi_pio_baudrate;
+#else
+    return spi_get_baudrate(SPI_PORT);
+#endif
+}
+
 void wizchip_spi_initialize(void)
 {
-    // this example will use SPI0 at 5MHz
-    spi_init(SPI_PORT, 5000 * 1000);
+#ifdef USE_SPI_PIO
+    dma_channel_config config;
+    uint offset;
+
+    // the program frames opcode, address and CS by itself, at 5MHz until wizchip_spi_tune()
+    g_spi_pio_sm = pio_claim_unused_sm(SPI_PIO, true);
+    offset = pio_add_program(SPI_PIO, &w5x00_spi_program);
+    w5x00_spi_program_init(SPI_PIO, g_spi_pio_sm, offset, PIN_MOSI, PIN_MISO, PIN_CS, 1.0f);
+    wizchip_spi_set_baudrate(SPI_BAUD_DEFAULT);
+
+    // make the SPI pins available to picotool
+    bi_decl(bi_4pins_with_func(PIN_MISO, PIN_MOSI, PIN_SCK, PIN_CS, GPIO_FUNC_PIO0));
+
+    g_spi_pio_dma_tx = dma_claim_unused_channel(true);
+    g_spi_pio_dma_rx = dma_claim_unused_channel(true);
+    g_spi_pio_dma_ctrl = dma_claim_unused_channel(true);
+
+    // TX, one control word per block size, chained back to the control channel for the next block
+    config = dma_channel_get_default_config(g_spi_pio_dma_tx);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, pio_get_dreq(SPI_PIO, g_spi_pio_sm, true));
+    channel_config_set_chain_to(&config, g_spi_pio_dma_ctrl);
+    channel_config_set_irq_quiet(&config, true);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    g_spi_pio_ctrl_header = channel_config_get_ctrl_value(&config);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+    g_spi_pio_ctrl_data = channel_config_get_ctrl_value(&config);
+
+    // RX, the low byte of each FIFO entry
+    config = dma_channel_get_default_config(g_spi_pio_dma_rx);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_write_increment(&config, true);
+    channel_config_set_dreq(&config, pio_get_dreq(SPI_PIO, g_spi_pio_sm, false));
+    dma_channel_configure(g_spi_pio_dma_rx, &config, NULL, &SPI_PIO->rxf[g_spi_pio_sm], 0, false);
+
+    // control, writes a whole block over the TX alias 0 registers, the last one in it triggers
+    config = dma_channel_get_default_config(g_spi_pio_dma_ctrl);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, true);
+    channel_config_set_ring(&config, true, 4);
+    dma_channel_configure(g_spi_pio_dma_ctrl, &config, &dma_hw->ch[g_spi_pio_dma_tx].read_addr, g_spi_pio_block, 4, false);
+#else
+    // this example will use SPI0 at 5MHz until wizchip_spi_tune()
+    spi_init(SPI_PORT, SPI_BAUD_DEFAULT);
 
     gpio_set_function(PIN_SCK, GPIO_FUNC_SPI);
     gpio_set_function(PIN_MOSI, GPIO_FUNC_SPI);
@@ -169,6 +499,27 @@ void wizchip_spi_initialize(void)
     channel_config_set_dreq(&dma_channel_config_rx, DREQ_SPI0_RX);
     channel_config_set_read_increment(&dma_channel_config_rx, false);
     channel_config_set_write_increment(&dma_channel_config_rx, true);
+
+    // The gather write uses its own copy of the TX config, chained to the control channel.
+    // The control channel rewrites two words of dma_tx per piece, so its write address rings over 8 bytes
+    dma_ctrl = dma_claim_unused_channel(true);
+
+    dma_channel_config_vec = dma_channel_config_tx;
+    channel_config_set_read_increment(&dma_channel_config_vec, true);
+    channel_config_set_write_increment(&dma_channel_config_vec, false);
+    channel_config_set_chain_to(&dma_channel_config_vec, dma_ctrl);
+    channel_config_set_irq_quiet(&dma_channel_config_vec, true);
+
+    dma_channel_config_ctrl = dma_channel_get_default_config(dma_ctrl);
+    channel_config_set_transfer_data_size(&dma_channel_config_ctrl, DMA_SIZE_32);
+    channel_config_set_read_increment(&dma_channel_config_ctrl, true);
+    channel_config_set_write_increment(&dma_channel_config_ctrl, true);
+    channel_config_set_ring(&dma_channel_config_ctrl, true, 3);
+
+    // completion of the asynchronous write, on core0 with the rest of the SPI traffic
+    irq_add_shared_handler(SPI_DMA_IRQ, wizchip_spi_dma_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(SPI_DMA_IRQ, true);
+#endif
 #endif
 }
 
@@ -184,12 +535,20 @@ void wizchip_initialize(void)
     wizchip_deselect();
 
     /* CS function register */
+#ifndef USE_SPI_PIO
     reg_wizchip_cs_cbfunc(wizchip_select, wizchip_deselect);
+#endif
 
     /* SPI function register */
     reg_wizchip_spi_cbfunc(wizchip_read, wizchip_write);
+#ifdef USE_SPI_PIO
+    reg_wizchip_spiframe_cbfunc(wizchip_pio_frame);
+    reg_wizchip_spiburst_async_cbfunc(wizchip_pio_frame_async);
+#endif
 #ifdef USE_SPI_DMA
     reg_wizchip_spiburst_cbfunc(wizchip_read_burst, wizchip_write_burst);
+    reg_wizchip_spiburst_vec_cbfunc(wizchip_write_burst_vec);
+    reg_wizchip_spiburst_async_cbfunc(wizchip_write_burst_vec_async);
 #endif
 
     /* W5x00 initialize */
@@ -238,6 +597,183 @@ void wizchip_check(void)
 #endif
 }
 
+/* SPI clock */
+static uint32_t wizchip_spi_tune_check(const spi_tune_record_t *record)
+{
+    const uint8_t *p = (const uint8_t *)record;
+    uint32_t check = 0x811C9DC5;
+    uint32_t i;
+
+    // FNV-1a over everything in front of check
+    for (i = 0; i < offsetof(spi_tune_record_t, check); i++)
+        check = (check ^ p[i]) * 0x01000193;
+
+    return check;
+}
+
+static uint32_t wizchip_spi_set_div(uint32_t div)
+{
+    return wizchip_spi_set_baudrate(clock_get_hz(clk_peri) / (2 * div));
+}
+
+static uint8_t wizchip_spi_verify(uint16_t rounds, uint8_t pattern)
+{
+    uint16_t round;
+    uint16_t i;
+    uint32_t x;
+
+    for (round = 0; round < rounds; round++)
+    {
+#if (_WIZCHIP_ == W5100S)
+        if (getVER() != 0x51)
+            return 0;
+
+        if (!pattern)
+            continue;
+
+        // stuck lines and crosstalk first, then a pseudo-random pattern
+        x = 0x9E3779B9 * (round + 1);
+        for (i = 0; i < SPI_TUNE_PATTERN_SIZE; i++)
+        {
+            switch (round)
+            {
+            case 0: g_spi_tune_pattern[i] = 0x00; break;
+            case 1: g_spi_tune_pattern[i] = 0xFF; break;
+            case 2: g_spi_tune_pattern[i] = (i & 1) ? 0x55 : 0xAA; break;
+            case 3: g_spi_tune_pattern[i] = 1 << (i & 7); break;
+            default:
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                g_spi_tune_pattern[i] = (uint8_t)x;
+                break;
+            }
+        }
+
+        // TX buffer of socket 0, nothing is open while tuning
+        WIZCHIP_WRITE_BUF(getSn_TxBASE(0), g_spi_tune_pattern, SPI_TUNE_PATTERN_SIZE);
+        memset(g_spi_tune_readback, ~g_spi_tune_pattern[0], SPI_TUNE_PATTERN_SIZE);
+        WIZCHIP_READ_BUF(getSn_TxBASE(0), g_spi_tune_readback, SPI_TUNE_PATTERN_SIZE);
+        if (memcmp(g_spi_tune_pattern, g_spi_tune_readback, SPI_TUNE_PATTERN_SIZE) != 0)
+            return 0;
+#elif (_WIZCHIP_ == W5500)
+        if (getVERSIONR() != 0x04)
+            return 0;
+#endif
+    }
+
+    return 1;
+}
+
+static void wizchip_spi_tune_save(uint32_t div)
+{
+    const spi_tune_record_t *stored = (const spi_tune_record_t *)(XIP_BASE + SPI_TUNE_FLASH_OFFSET);
+    static uint8_t page[FLASH_PAGE_SIZE];
+    spi_tune_record_t *record = (spi_tune_record_t *)page;
+    uint32_t ints;
+
+    memset(page, 0xFF, sizeof(page));
+    record->magic = SPI_TUNE_MAGIC;
+    record->peri_hz = clock_get_hz(clk_peri);
+    record->div = div;
+    pico_get_unique_board_id((pico_unique_board_id_t *)record->board_id);
+    record->check = wizchip_spi_tune_check(record);
+
+    // the sector is only rewritten when the result changed
+    if (memcmp(stored, record, sizeof(spi_tune_record_t)) == 0)
+        return;
+
+    ints = save_and_disable_interrupts();
+    flash_range_erase(SPI_TUNE_FLASH_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(SPI_TUNE_FLASH_OFFSET, page, FLASH_PAGE_SIZE);
+    restore_interrupts(ints);
+}
+
+void wizchip_spi_tune(void)
+{
+    const spi_tune_record_t *stored = (const spi_tune_record_t *)(XIP_BASE + SPI_TUNE_FLASH_OFFSET);
+    uint8_t board_id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES];
+    int8_t index = -1;
+    uint8_t i;
+
+    // a stored rate only has to pass the long check again
+    pico_get_unique_board_id((pico_unique_board_id_t *)board_id);
+    if ((stored->magic == SPI_TUNE_MAGIC) && (stored->check == wizchip_spi_tune_check(stored)) &&
+        (stored->peri_hz == clock_get_hz(clk_peri)) && (memcmp(stored->board_id, board_id, sizeof(board_id)) == 0))
+    {
+        for (i = 0; i < count_of(g_spi_tune_div); i++)
+        {
+            if (g_spi_tune_div[i] == stored->div)
+                index = i;
+        }
+
+        if (index >= 0)
+        {
+            g_spi_tune_index = index;
+            printf(" SPI clock %lu Hz, stored\n", wizchip_spi_set_div(g_spi_tune_div[index]));
+            if (wizchip_spi_verify(SPI_TUNE_CONFIRM_ROUNDS, 1))
+                return;
+
+            printf(" SPI clock failed, tune again\n");
+            index = -1;
+        }
+    }
+
+    // step up until the first error
+    for (i = 0; i < count_of(g_spi_tune_div); i++)
+    {
+        wizchip_spi_set_div(g_spi_tune_div[i]);
+        if (!wizchip_spi_verify(SPI_TUNE_ROUNDS, 1))
+            break;
+
+        index = i;
+    }
+
+    // then settle on the fastest that passes the long check
+    while (index >= 0)
+    {
+        wizchip_spi_set_div(g_spi_tune_div[index]);
+        if (wizchip_spi_verify(SPI_TUNE_CONFIRM_ROUNDS, 1))
+            break;
+
+        index--;
+    }
+
+    if (index < 0)
+    {
+        wizchip_spi_set_baudrate(SPI_BAUD_DEFAULT);
+        g_spi_tune_index = -1;
+        printf(" SPI clock tuning failed, %lu Hz\n", wizchip_spi_get_baudrate());
+
+        return;
+    }
+
+    g_spi_tune_index = index;
+    wizchip_spi_tune_save(g_spi_tune_div[index]);
+    printf(" SPI clock %lu Hz, tuned\n", wizchip_spi_get_baudrate());
+}
+
+uint8_t wizchip_spi_check(void)
+{
+    // sockets are open, only registers are read
+    if (wizchip_spi_verify(SPI_CHECK_ROUNDS, 0))
+        return 1;
+
+    // one step down, the stored rate is checked again on the next boot
+    if (g_spi_tune_index > 0)
+    {
+        g_spi_tune_index--;
+        printf(" SPI check failed, %lu Hz\n", wizchip_spi_set_div(g_spi_tune_div[g_spi_tune_index]));
+    }
+    else
+    {
+        g_spi_tune_index = -1;
+        printf(" SPI check failed, %lu Hz\n", wizchip_spi_set_baudrate(SPI_BAUD_DEFAULT));
+    }
+
+    return 0;
+}
+
 /* Network */
 void network_initialize(wiz_NetInfo net_info)
 {
@@ -21,8 +21,30 @@
 #define PIN_CS 17
 #define PIN_RST 20
 
+/* SPI clock */
+#define SPI_BAUD_DEFAULT (5000 * 1000)      // until wizchip_spi_tune(), and when tuning fails
+#define SPI_TUNE_ROUNDS 8                   // pattern rounds per step while stepping up
+#define SPI_TUNE_CONFIRM_ROUNDS 64          // pattern rounds the chosen clock has to pass
+#define SPI_TUNE_PATTERN_SIZE 256           // bytes per round, written to the socket 0 TX buffer
+#define SPI_CHECK_ROUNDS 4                  // version reads per wizchip_spi_check()
+#define SPI_TUNE_MAGIC 0x53504943           // "SPIC"
+#define SPI_TUNE_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE) // last flash sector
+
+/* Use PIO SPI */
+//#define USE_SPI_PIO // if you want opcode, address and CS framed by a PIO program instead of the SPI block, uncomment.
+
 /* Use SPI DMA */
-//#define USE_SPI_DMA // if you want to use SPI DMA, uncomment.
+#if !defined(NO_SPI_DMA) && !defined(USE_SPI_PIO)
+#define USE_SPI_DMA // on by default, build with NO_SPI_DMA defined for byte transfers only
+#endif
+
+/* PIO SPI, PIN_CS and PIN_SCK must be consecutive for side-set */
+#define SPI_PIO pio0
+#define SPI_PIO_CYCLES_PER_BIT 4      // SCK = clk_sys / (4 x clkdiv), clk_sys / 4 at most
+#define SPI_PIO_READ_MAX 8191         // bytes read per frame, the header counts 16 bits
+
+/* SPI DMA IRQ, DMA_IRQ_0 belongs to the capture modules on core1 */
+#define SPI_DMA_IRQ DMA_IRQ_1
 
 /* Clock */
 #define PLL_SYS_KHZ (133 * 1000)
@@ -91,6 +113,90 @@ static void wizchip_read_burst(uint8_t *pBuf, uint16_t len);
  * \param len element count (each element is of size transfer_data_size)
  */
 static void wizchip_write_burst(uint8_t *pBuf, uint16_t len);
+
+/*! \brief Write several buffers back to back with chained DMA
+ *  \ingroup w5x00_spi
+ * 
+ * A control channel loads the count and read address of each piece into the TX channel,
+ * which chains back to it when the piece is done, so the pieces leave in one SPI frame
+ * without being copied together. Zero-length pieces are skipped.
+ * 
+ * \param vec Pieces to write, up to WIZ_IOVEC_MAX + 2
+ * \param cnt Number of pieces
+ */
+static void wizchip_write_burst_vec(wiz_IOVec *vec, uint8_t cnt);
+
+/*! \brief Start a chained DMA write and return
+ *  \ingroup w5x00_spi
+ * 
+ * Same chain as wizchip_write_burst_vec(), but returns as soon as the transfer is started.
+ * The completion IRQ on SPI_DMA_IRQ deselects the chip. The next critical section lock
+ * finishes it first if the IRQ has not run yet, so the pieces must stay unchanged until then.
+ * 
+ * \param vec Pieces to write, up to WIZ_IOVEC_MAX + 2
+ * \param cnt Number of pieces
+ */
+static void wizchip_write_burst_vec_async(wiz_IOVec *vec, uint8_t cnt);
+
+/*! \brief Finish the asynchronous write
+ *  \ingroup w5x00_spi
+ * 
+ * Wait for the RX channel to drain and deselect the chip. Called with interrupts disabled
+ * or from the completion IRQ.
+ * 
+ * \param none
+ */
+static void wizchip_spi_async_finish(void);
+#endif
+
+#ifdef USE_SPI_PIO
+/*! \brief Start a PIO SPI frame
+ *  \ingroup w5x00_spi
+ * 
+ * Build the command stream of one transaction, the header word then the pieces to write,
+ * as DMA control blocks, and start it. A control channel loads each block into the TX channel,
+ * which chains back to it, so the stream runs to the end without the CPU.
+ * The read bytes go to rx through the RX channel.
+ * 
+ * \param tx Pieces to write, opcode and address first, up to WIZ_IOVEC_MAX + 2
+ * \param cnt Number of pieces
+ * \param rx Buffer for the read bytes
+ * \param rxlen Bytes to read, up to SPI_PIO_READ_MAX
+ */
+static void wizchip_pio_frame_start(wiz_IOVec *tx, uint8_t cnt, uint8_t *rx, uint16_t rxlen);
+
+/*! \brief Run a PIO SPI frame
+ *  \ingroup w5x00_spi
+ * 
+ * Write the pieces and read rxlen bytes in one chip select, and wait for the end of the frame.
+ * Longer reads than SPI_PIO_READ_MAX continue in further frames at the following address.
+ * 
+ * \param tx Pieces to write, opcode and address first
+ * \param cnt Number of pieces
+ * \param rx Buffer for the read bytes
+ * \param rxlen Bytes to read
+ */
+static void wizchip_pio_frame(wiz_IOVec *tx, uint8_t cnt, uint8_t *rx, uint16_t rxlen);
+
+/*! \brief Start a PIO SPI write frame and return
+ *  \ingroup w5x00_spi
+ * 
+ * The program raises CS at the end of the frame itself, the next critical section lock
+ * waits for it, so the pieces must stay unchanged until then.
+ * 
+ * \param vec Pieces to write, opcode and address first
+ * \param cnt Number of pieces
+ */
+static void wizchip_pio_frame_async(wiz_IOVec *vec, uint8_t cnt);
+
+/*! \brief Finish the asynchronous frame
+ *  \ingroup w5x00_spi
+ * 
+ * Wait for the IRQ flag the program raises at the end of the frame.
+ * 
+ * \param none
+ */
+static void wizchip_spi_async_finish(void);
 #endif
 
 /*! \brief Enter a critical section
@@ -117,6 +223,7 @@ static void wizchip_critical_section_unlock(void);
  * Set GPIO to spi0.
  * Puts the SPI into a known state, and enable it.
  * Set DMA channel completion channel.
+ * With USE_SPI_PIO the pins go to the w5x00_spi program on SPI_PIO instead, with its DMA channels.
  * 
  * \param none
  */
@@ -159,6 +266,48 @@ void wizchip_initialize(void);
  */
 void wizchip_check(void);
 
+/*! \brief Check for an asynchronous SPI write
+ *  \ingroup w5x00_spi
+ * 
+ * \param none
+ * \return true while a write started by WIZCHIP_WRITE_BUF_VEC_ASYNC() is still going out, false without USE_SPI_DMA or USE_SPI_PIO
+ */
+bool wizchip_spi_busy(void);
+
+/*! \brief Wait for an asynchronous SPI write
+ *  \ingroup w5x00_spi
+ * 
+ * Return once the last write started by WIZCHIP_WRITE_BUF_VEC_ASYNC() is done and its buffers can be reused.
+ * 
+ * \param none
+ */
+void wizchip_spi_wait(void);
+
+/* SPI clock */
+/*! \brief Tune SPI clock
+ *  \ingroup w5x00_spi
+ * 
+ * Step the SCK divider of clk_peri down from SPI_BAUD_DEFAULT, checking each step with version
+ * reads and pattern writes and reads through the socket 0 TX buffer, stop at the first error and
+ * settle on the fastest clock that passes the longer check. The result is kept in the last flash
+ * sector for this board and clk_peri, the next boot only checks it again.
+ * Call after wizchip_check(), before any socket is opened and before core1 is launched,
+ * the flash write stops execution from flash.
+ * 
+ * \param none
+ */
+void wizchip_spi_tune(void);
+
+/*! \brief Check SPI clock
+ *  \ingroup w5x00_spi
+ * 
+ * Read the version register. On an error step the clock one divider down until the next boot.
+ * No buffer is written, sockets may be open.
+ * 
+ * \return 1 on success, 0 when the clock was lowered
+ */
+uint8_t wizchip_spi_check(void);
+
 /* Network */
 /*! \brief Initialize network
  *  \ingroup w5x00_spi
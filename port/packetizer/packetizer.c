@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stddef.h>
+
+#include "packetizer.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+static uint32_t packetizer_convert(packetizer_t *pk, uint8_t input, const void *smp, uint32_t count, uint8_t *out)
+{
+    switch (input)
+    {
+    case PACKETIZER_INPUT_ADC12:
+        return sample_convert_raw(pk->conv, smp, count, out);
+    case PACKETIZER_INPUT_PCM16:
+        return sample_convert_pcm(pk->conv, smp, count, out);
+    default:
+        return sample_convert_s32(pk->conv, smp, count, out);
+    }
+}
+
+void packetizer_init(packetizer_t *pk, frame_queue_t *queue, sample_convert_t *conv, uint16_t packet_size, uint8_t channels, uint32_t queue_limit)
+{
+    pk->queue = queue;
+    pk->conv = conv;
+    pk->channels = channels ? channels : 1;
+    pk->queue_limit = ((queue_limit == 0) || (queue_limit > FRAME_QUEUE_DEPTH)) ? FRAME_QUEUE_DEPTH : queue_limit;
+    pk->group_size = sample_convert_get_width(conv->format) * pk->channels;
+    pk->packet_size = (packet_size / pk->group_size) * pk->group_size;
+
+    if (pk->packet_size > (FRAME_POOL_FRAME_SIZE / pk->group_size) * pk->group_size)
+        pk->packet_size = (FRAME_POOL_FRAME_SIZE / pk->group_size) * pk->group_size;
+
+    if (pk->packet_size == 0)
+        pk->packet_size = pk->group_size;
+
+    pk->frame = NULL;
+    pk->drop = 0;
+}
+
+void packetizer_put(packetizer_t *pk, uint8_t input, const void *smp, uint32_t count, uint64_t time_us, uint64_t index)
+{
+    uint8_t elem = (input == PACKETIZER_INPUT_S32) ? 4 : 2;
+    uint32_t groups = count / pk->channels;
+    uint32_t n;
+
+    while (groups > 0)
+    {
+        if (pk->frame == NULL)
+        {
+            if ((pk->frame = frame_pool_take()) == NULL)
+            {
+                /* Sender is behind, drop the rest of this capture frame */
+                pk->drop++;
+
+                return;
+            }
+
+            /* index + groups stays the end of this capture frame, the one time_us belongs to */
+            pk->frame->timestamp_us = time_us;
+            pk->frame->sample_index = index;
+            pk->frame->sync_index = index + groups;
+        }
+
+        n = (pk->packet_size - pk->frame->len) / pk->group_size;
+
+        if (n > groups)
+            n = groups;
+
+        pk->frame->len += packetizer_convert(pk, input, smp, n * pk->channels, &pk->frame->data[pk->frame->len]);
+        smp = (const uint8_t *)smp + n * pk->channels * elem;
+        groups -= n;
+        index += n;
+
+        if (pk->frame->len >= pk->packet_size)
+        {
+            if ((frame_queue_get_level(pk->queue) >= pk->queue_limit) || !frame_queue_push(pk->queue, pk->frame))
+            {
+                pk->drop++;
+                frame_pool_give(pk->frame);
+            }
+
+            pk->frame = NULL;
+        }
+    }
+}
+
+void packetizer_flush(packetizer_t *pk)
+{
+    if (pk->frame != NULL)
+    {
+        frame_pool_give(pk->frame);
+        pk->frame = NULL;
+    }
+}
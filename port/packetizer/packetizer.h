@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PACKETIZER_H_
+#define _PACKETIZER_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+
+#include "frame_pool.h"
+#include "frame_queue.h"
+#include "sample_convert.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Input */
+#define PACKETIZER_INPUT_ADC12 0 // raw ADC words, see sample_convert_raw()
+#define PACKETIZER_INPUT_PCM16 1 // signed 16-bit, see sample_convert_pcm()
+#define PACKETIZER_INPUT_S32 2   // left-justified 32-bit, see sample_convert_s32()
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+typedef struct packetizer_t
+{
+    frame_queue_t *queue;   // full packets go here
+    sample_convert_t *conv; // wire format
+    uint16_t packet_size;   // payload bytes per packet
+    uint16_t group_size;    // bytes per sample group (all channels) on the wire
+    uint8_t channels;       // samples per group
+    uint32_t queue_limit;   // packets waiting in queue at most, keeps one slow receiver from taking the whole pool
+    frame_t *frame;         // packet being filled
+    volatile uint32_t drop; // capture frames or packets lost to a full pool or queue
+} packetizer_t;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Packetizer */
+/*! \brief Initialize packetizer
+ *  \ingroup packetizer
+ *
+ * \param pk Packetizer
+ * \param queue Queue taking full packets
+ * \param conv Sample converter, its format sets the sample width
+ * \param packet_size Payload bytes per packet, a multiple of the group size up to FRAME_POOL_FRAME_SIZE
+ * \param channels Interleaved channels per sample group
+ * \param queue_limit Packets waiting in queue at most, 1 ~ FRAME_QUEUE_DEPTH, a packet over it counts as a drop
+ */
+void packetizer_init(packetizer_t *pk, frame_queue_t *queue, sample_convert_t *conv, uint16_t packet_size, uint8_t channels, uint32_t queue_limit);
+
+/*! \brief Add captured samples
+ *  \ingroup packetizer
+ *
+ * Convert samples into the packet being filled and push each packet once it holds
+ * packet_size bytes. A capture frame may end up split over two packets, or several
+ * capture frames may make up one packet, so the packet rate only follows packet_size.
+ * If the pool is empty the rest of the samples are dropped, a full packet over
+ * queue_limit is dropped as well.
+ *
+ * \param pk Packetizer
+ * \param input PACKETIZER_INPUT_xxx
+ * \param smp Interleaved samples
+ * \param count Number of samples, all channels, a multiple of the channel count
+ * \param time_us Capture time of the frame holding smp
+ * \param index Sample group index of the first sample
+ */
+void packetizer_put(packetizer_t *pk, uint8_t input, const void *smp, uint32_t count, uint64_t time_us, uint64_t index);
+
+/*! \brief Drop the partial packet
+ *  \ingroup packetizer
+ *
+ * \param pk Packetizer
+ */
+void packetizer_flush(packetizer_t *pk);
+
+#endif /* _PACKETIZER_H_ */
@@ -0,0 +1,254 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+
+#include "pio_capture.h"
+#include "i2s_in.pio.h"
+#include "pdm_in.pio.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Buffer */
+static uint32_t g_pio_capture_buf[PIO_CAPTURE_BUFFER_COUNT][PIO_CAPTURE_FRAME_WORDS_MAX];
+static uint16_t g_pio_capture_frame_words = PIO_CAPTURE_FRAME_WORDS_MAX;
+
+/* PIO */
+static uint g_pio_capture_sm;
+static const pio_program_t *g_pio_capture_program = NULL;
+static uint g_pio_capture_offset;
+
+/* DMA */
+static uint g_pio_capture_dma[PIO_CAPTURE_BUFFER_COUNT];
+static dma_channel_config g_pio_capture_dma_config[PIO_CAPTURE_BUFFER_COUNT];
+
+/* Status */
+static volatile uint8_t g_pio_capture_ready[PIO_CAPTURE_BUFFER_COUNT];
+static volatile uint32_t g_pio_capture_overrun = 0;
+static uint8_t g_pio_capture_read_index = 0;
+
+/* Timestamp */
+static volatile uint64_t g_pio_capture_time[PIO_CAPTURE_BUFFER_COUNT];
+static volatile uint64_t g_pio_capture_index[PIO_CAPTURE_BUFFER_COUNT];
+static uint64_t g_pio_capture_word_count = 0;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+static uint32_t pio_capture_get_bits(uint8_t mode)
+{
+    return (mode == PIO_CAPTURE_MODE_PDM) ? PIO_CAPTURE_PDM_OVERSAMPLE : PIO_CAPTURE_I2S_BITS_PER_FRAME;
+}
+
+static float pio_capture_get_clkdiv(uint32_t bits, uint32_t sample_rate)
+{
+    float clkdiv;
+
+    /* clk_sys / (rate x bits per sample x cycles per bit), PIO divider has 8 fractional bits */
+    clkdiv = (float)clock_get_hz(clk_sys) / (float)(sample_rate * bits * PIO_CAPTURE_CYCLES_PER_BIT);
+
+    if (clkdiv < 1.0f)
+        clkdiv = 1.0f;
+
+    return (float)((uint32_t)(clkdiv * 256.0f)) / 256.0f;
+}
+
+static void pio_capture_dma_handler(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < PIO_CAPTURE_BUFFER_COUNT; i++)
+    {
+        if (!dma_channel_get_irq0_status(g_pio_capture_dma[i]))
+            continue;
+
+        dma_channel_acknowledge_irq0(g_pio_capture_dma[i]);
+
+        g_pio_capture_time[i] = time_us_64();
+        g_pio_capture_index[i] = g_pio_capture_word_count;
+        g_pio_capture_word_count += g_pio_capture_frame_words;
+
+        /* Re-arm without triggering, the other channel chains back to this one */
+        dma_channel_set_write_addr(g_pio_capture_dma[i], g_pio_capture_buf[i], false);
+
+        if (g_pio_capture_ready[i])
+            g_pio_capture_overrun++;
+
+        g_pio_capture_ready[i] = 1;
+    }
+}
+
+void pio_capture_initialize(void)
+{
+    uint8_t i;
+
+    g_pio_capture_sm = pio_claim_unused_sm(PIO_CAPTURE_PIO, true);
+
+    for (i = 0; i < PIO_CAPTURE_BUFFER_COUNT; i++)
+        g_pio_capture_dma[i] = dma_claim_unused_channel(true);
+
+    for (i = 0; i < PIO_CAPTURE_BUFFER_COUNT; i++)
+    {
+        g_pio_capture_dma_config[i] = dma_channel_get_default_config(g_pio_capture_dma[i]);
+        channel_config_set_transfer_data_size(&g_pio_capture_dma_config[i], DMA_SIZE_32);
+        channel_config_set_read_increment(&g_pio_capture_dma_config[i], false);
+        channel_config_set_write_increment(&g_pio_capture_dma_config[i], true);
+        channel_config_set_dreq(&g_pio_capture_dma_config[i], pio_get_dreq(PIO_CAPTURE_PIO, g_pio_capture_sm, false));
+        channel_config_set_chain_to(&g_pio_capture_dma_config[i], g_pio_capture_dma[(i + 1) % PIO_CAPTURE_BUFFER_COUNT]);
+
+        dma_channel_configure(g_pio_capture_dma[i], &g_pio_capture_dma_config[i],
+                              g_pio_capture_buf[i],                    // write address
+                              &PIO_CAPTURE_PIO->rxf[g_pio_capture_sm], // read address
+                              g_pio_capture_frame_words,               // element count
+                              false);                                  // don't start yet
+
+        dma_channel_set_irq0_enabled(g_pio_capture_dma[i], true);
+    }
+
+    irq_add_shared_handler(PIO_CAPTURE_DMA_IRQ, pio_capture_dma_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(PIO_CAPTURE_DMA_IRQ, true);
+}
+
+uint32_t pio_capture_configure(uint8_t mode, uint32_t sample_rate, uint16_t frame_words)
+{
+    const pio_program_t *program;
+    uint32_t bits;
+    float clkdiv;
+
+    if (frame_words == 0)
+        frame_words = PIO_CAPTURE_FRAME_WORDS_MAX;
+    else if (frame_words > PIO_CAPTURE_FRAME_WORDS_MAX)
+        frame_words = PIO_CAPTURE_FRAME_WORDS_MAX;
+
+    g_pio_capture_frame_words = frame_words;
+
+    program = (mode == PIO_CAPTURE_MODE_PDM) ? &pdm_in_program : &i2s_in_program;
+    bits = pio_capture_get_bits(mode);
+    clkdiv = pio_capture_get_clkdiv(bits, sample_rate);
+
+    if (g_pio_capture_program != NULL)
+        pio_remove_program(PIO_CAPTURE_PIO, g_pio_capture_program, g_pio_capture_offset);
+
+    g_pio_capture_program = program;
+    g_pio_capture_offset = pio_add_program(PIO_CAPTURE_PIO, program);
+
+    if (mode == PIO_CAPTURE_MODE_PDM)
+        pdm_in_program_init(PIO_CAPTURE_PIO, g_pio_capture_sm, g_pio_capture_offset,
+                            PIO_CAPTURE_PDM_DATA_PIN, PIO_CAPTURE_PDM_CLOCK_PIN, clkdiv);
+    else
+        i2s_in_program_init(PIO_CAPTURE_PIO, g_pio_capture_sm, g_pio_capture_offset,
+                            PIO_CAPTURE_I2S_DATA_PIN, PIO_CAPTURE_I2S_CLOCK_PIN_BASE, clkdiv);
+
+    return pio_capture_get_rate(mode, sample_rate);
+}
+
+uint32_t pio_capture_get_rate(uint8_t mode, uint32_t sample_rate)
+{
+    uint32_t bits = pio_capture_get_bits(mode);
+
+    return (uint32_t)((float)clock_get_hz(clk_sys) / (pio_capture_get_clkdiv(bits, sample_rate) * bits * PIO_CAPTURE_CYCLES_PER_BIT) + 0.5f);
+}
+
+uint16_t pio_capture_get_frame_words(void)
+{
+    return g_pio_capture_frame_words;
+}
+
+void pio_capture_start(void)
+{
+    uint8_t i;
+
+    pio_sm_set_enabled(PIO_CAPTURE_PIO, g_pio_capture_sm, false);
+    pio_sm_clear_fifos(PIO_CAPTURE_PIO, g_pio_capture_sm);
+    pio_sm_restart(PIO_CAPTURE_PIO, g_pio_capture_sm);
+    pio_sm_exec(PIO_CAPTURE_PIO, g_pio_capture_sm, pio_encode_jmp(g_pio_capture_offset));
+
+    for (i = 0; i < PIO_CAPTURE_BUFFER_COUNT; i++)
+    {
+        g_pio_capture_ready[i] = 0;
+        dma_channel_set_write_addr(g_pio_capture_dma[i], g_pio_capture_buf[i], false);
+        dma_channel_set_trans_count(g_pio_capture_dma[i], g_pio_capture_frame_words, false);
+    }
+    g_pio_capture_read_index = 0;
+    g_pio_capture_overrun = 0;
+    g_pio_capture_word_count = 0;
+
+    dma_channel_start(g_pio_capture_dma[0]);
+    pio_sm_set_enabled(PIO_CAPTURE_PIO, g_pio_capture_sm, true);
+}
+
+void pio_capture_stop(void)
+{
+    uint8_t i;
+    uint32_t mask = 0;
+
+    pio_sm_set_enabled(PIO_CAPTURE_PIO, g_pio_capture_sm, false);
+
+    for (i = 0; i < PIO_CAPTURE_BUFFER_COUNT; i++)
+    {
+        dma_channel_set_irq0_enabled(g_pio_capture_dma[i], false);
+        mask |= 1u << g_pio_capture_dma[i];
+    }
+
+    /* Abort both at once so neither can chain-trigger the other */
+    dma_hw->abort = mask;
+    while (dma_hw->abort & mask)
+        tight_loop_contents();
+
+    for (i = 0; i < PIO_CAPTURE_BUFFER_COUNT; i++)
+    {
+        dma_channel_acknowledge_irq0(g_pio_capture_dma[i]);
+        dma_channel_set_irq0_enabled(g_pio_capture_dma[i], true);
+        g_pio_capture_ready[i] = 0;
+    }
+
+    pio_sm_clear_fifos(PIO_CAPTURE_PIO, g_pio_capture_sm);
+}
+
+uint32_t *pio_capture_get_frame(void)
+{
+    if (!g_pio_capture_ready[g_pio_capture_read_index])
+        return NULL;
+
+    return g_pio_capture_buf[g_pio_capture_read_index];
+}
+
+void pio_capture_release_frame(void)
+{
+    g_pio_capture_ready[g_pio_capture_read_index] = 0;
+    g_pio_capture_read_index = (g_pio_capture_read_index + 1) % PIO_CAPTURE_BUFFER_COUNT;
+}
+
+uint64_t pio_capture_get_frame_time(void)
+{
+    return g_pio_capture_time[g_pio_capture_read_index];
+}
+
+uint64_t pio_capture_get_frame_index(void)
+{
+    return g_pio_capture_index[g_pio_capture_read_index];
+}
+
+uint32_t pio_capture_get_overrun(void)
+{
+    return g_pio_capture_overrun;
+}
@@ -0,0 +1,161 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PIO_CAPTURE_H_
+#define _PIO_CAPTURE_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Mode */
+#define PIO_CAPTURE_MODE_I2S 0 // stereo I2S master, one 32-bit word per channel
+#define PIO_CAPTURE_MODE_PDM 1 // mono PDM, 32 bitstream bits per word
+
+/* Pin */
+#ifndef PIO_CAPTURE_I2S_DATA_PIN
+#define PIO_CAPTURE_I2S_DATA_PIN 10
+#endif
+#ifndef PIO_CAPTURE_I2S_CLOCK_PIN_BASE
+#define PIO_CAPTURE_I2S_CLOCK_PIN_BASE 11 // BCLK, LRCLK on the next pin
+#endif
+#ifndef PIO_CAPTURE_PDM_DATA_PIN
+#define PIO_CAPTURE_PDM_DATA_PIN 13
+#endif
+#ifndef PIO_CAPTURE_PDM_CLOCK_PIN
+#define PIO_CAPTURE_PDM_CLOCK_PIN 14
+#endif
+
+/* Clock */
+#define PIO_CAPTURE_I2S_BITS_PER_FRAME 64 // two 32-bit slots
+#define PIO_CAPTURE_PDM_OVERSAMPLE 64     // PDM bits per output sample, matches DECIMATOR_PDM_FACTOR
+#define PIO_CAPTURE_CYCLES_PER_BIT 2      // both programs run one clock edge per instruction
+
+/* Frame */
+#define PIO_CAPTURE_FRAME_WORDS_MAX 512 // ping-pong buffer size
+#define PIO_CAPTURE_BUFFER_COUNT 2      // ping-pong
+
+/* PIO, DMA IRQ */
+#define PIO_CAPTURE_PIO pio1
+#define PIO_CAPTURE_DMA_IRQ DMA_IRQ_0
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Capture */
+/*! \brief Initialize PIO capture
+ *  \ingroup pio_capture
+ *
+ * Claim a state machine and two DMA channels. Each channel fills one half of the
+ * ping-pong buffer from the RX FIFO and chains to the other.
+ *
+ * \param none
+ */
+void pio_capture_initialize(void);
+
+/*! \brief Configure PIO capture
+ *  \ingroup pio_capture
+ *
+ * Load the program for the mode and set the PIO clock for the sample rate.
+ * Only call while capture is stopped.
+ *
+ * \param mode PIO_CAPTURE_MODE_I2S or PIO_CAPTURE_MODE_PDM
+ * \param sample_rate Output samples per second
+ * \param frame_words 32-bit words per frame (1 ~ PIO_CAPTURE_FRAME_WORDS_MAX)
+ * \return Sample rate after divider rounding
+ */
+uint32_t pio_capture_configure(uint8_t mode, uint32_t sample_rate, uint16_t frame_words);
+
+/*! \brief Get PIO capture rate
+ *  \ingroup pio_capture
+ *
+ * Sample rate pio_capture_configure() will run at, from the same divider rounding at the current clk_sys.
+ * Safe to call from either core, with or without capture running.
+ *
+ * \param mode PIO_CAPTURE_MODE_I2S or PIO_CAPTURE_MODE_PDM
+ * \param sample_rate Output samples per second
+ * \return Sample rate after divider rounding
+ */
+uint32_t pio_capture_get_rate(uint8_t mode, uint32_t sample_rate);
+
+/*! \brief Get frame size
+ *  \ingroup pio_capture
+ *
+ * \param none
+ * \return 32-bit words per frame
+ */
+uint16_t pio_capture_get_frame_words(void);
+
+/*! \brief Start PIO capture
+ *  \ingroup pio_capture
+ *
+ * \param none
+ */
+void pio_capture_start(void);
+
+/*! \brief Stop PIO capture
+ *  \ingroup pio_capture
+ *
+ * Stop the state machine, abort both DMA channels and drop any pending frames.
+ *
+ * \param none
+ */
+void pio_capture_stop(void);
+
+/*! \brief Get a completed frame
+ *  \ingroup pio_capture
+ *
+ * Return the oldest completed frame in capture order. The frame must be returned with
+ * pio_capture_release_frame() before the other half of the ping-pong buffer completes.
+ *
+ * \param none
+ * \return Pointer to pio_capture_get_frame_words() words, NULL if no frame is ready
+ */
+uint32_t *pio_capture_get_frame(void);
+
+/*! \brief Release a frame
+ *  \ingroup pio_capture
+ *
+ * \param none
+ */
+void pio_capture_release_frame(void);
+
+/*! \brief Get frame timestamp
+ *  \ingroup pio_capture
+ *
+ * \param none
+ * \return time_us_64() taken in the DMA completion interrupt of the current frame
+ */
+uint64_t pio_capture_get_frame_time(void);
+
+/*! \brief Get frame word index
+ *  \ingroup pio_capture
+ *
+ * \param none
+ * \return Index of the first word of the current frame since pio_capture_start()
+ */
+uint64_t pio_capture_get_frame_index(void);
+
+/*! \brief Get overrun count
+ *  \ingroup pio_capture
+ *
+ * \param none
+ * \return Overrun count since pio_capture_start()
+ */
+uint32_t pio_capture_get_overrun(void);
+
+#endif /* _PIO_CAPTURE_H_ */
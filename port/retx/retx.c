@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <string.h>
+
+#include "socket.h"
+
+#include "retx.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+static uint64_t retx_get_be64(const uint8_t *p)
+{
+    uint64_t value = 0;
+    uint8_t i;
+
+    for (i = 0; i < 8; i++)
+        value = (value << 8) | p[i];
+
+    return value;
+}
+
+static retx_entry_t *retx_find(retx_t *retx, uint64_t index)
+{
+    uint8_t i;
+
+    for (i = 0; i < RETX_HISTORY_DEPTH; i++)
+    {
+        if ((retx->entry[i].frame != NULL) && (retx->entry[i].frame->sample_index == index))
+            return &retx->entry[i];
+    }
+
+    return NULL;
+}
+
+void retx_init(retx_t *retx, uint32_t sample_rate, uint16_t frame_samples)
+{
+    uint64_t depth;
+
+    memset(retx, 0, sizeof(retx_t));
+
+    /* Packets sent in RETX_HISTORY_MS, rounded up */
+    depth = ((uint64_t)RETX_HISTORY_MS * sample_rate + (1000 * (uint64_t)frame_samples) - 1) / (1000 * (uint64_t)frame_samples);
+
+    if (depth == 0)
+        depth = 1;
+    else if (depth > RETX_HISTORY_DEPTH)
+        depth = RETX_HISTORY_DEPTH;
+
+    retx->depth = (uint8_t)depth;
+}
+
+void retx_keep(retx_t *retx, frame_t *frame, uint8_t *data, uint16_t len)
+{
+    retx_entry_t *entry = &retx->entry[retx->next];
+
+    frame_pool_give(entry->frame);
+
+    entry->frame = frame;
+    entry->data = data;
+    entry->len = len;
+
+    retx->next = (retx->next + 1) % retx->depth;
+}
+
+void retx_clear(retx_t *retx)
+{
+    uint8_t i;
+
+    for (i = 0; i < RETX_HISTORY_DEPTH; i++)
+    {
+        frame_pool_give(retx->entry[i].frame);
+        retx->entry[i].frame = NULL;
+    }
+
+    retx->next = 0;
+}
+
+int8_t retx_is_nack(const uint8_t *buf, uint16_t len)
+{
+    return (len >= RETX_NACK_HEADER_SIZE) && (buf[0] == 'N') && (buf[1] == 'A') && (buf[2] == 'K');
+}
+
+uint8_t retx_process(retx_t *retx, uint8_t sn, const uint8_t *buf, uint16_t len, uint8_t *addr, uint16_t port)
+{
+    retx_entry_t *entry;
+    uint8_t count = buf[3];
+    uint8_t sent = 0;
+    uint8_t i;
+
+    if (count > RETX_NACK_INDEX_MAX)
+        count = RETX_NACK_INDEX_MAX;
+
+    if (count > (len - RETX_NACK_HEADER_SIZE) / 8)
+        count = (len - RETX_NACK_HEADER_SIZE) / 8;
+
+    for (i = 0; i < count; i++)
+    {
+        retx->request++;
+
+        if ((entry = retx_find(retx, retx_get_be64(buf + RETX_NACK_HEADER_SIZE + (i * 8)))) == NULL)
+        {
+            retx->miss++;
+            continue;
+        }
+
+        /* Unicast to the requester, other receivers of the broadcast are not asking */
+        if (sendto(sn, entry->data, entry->len, addr, port) > 0)
+        {
+            retx->resent++;
+            sent++;
+        }
+    }
+
+    return sent;
+}
@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _RETX_H_
+#define _RETX_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+
+#include "frame_pool.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* History, the host gives up on a missing packet after the same time (GAP_TRACK_HISTORY_MS) */
+#define RETX_HISTORY_MS 100   // sent packets are kept this long
+#define RETX_HISTORY_DEPTH 24 // at most, frames taken from the frame pool, RETX_HISTORY_MS up to 240 packets/s
+
+/* NACK, big endian
+ * 0 : 'N' 'A' 'K' <count>
+ * 4 : count x 64-bit sample index of a missing packet
+ */
+#define RETX_NACK_HEADER_SIZE 4
+#define RETX_NACK_INDEX_MAX 32
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+typedef struct retx_entry_t
+{
+    frame_t *frame; // sent frame, NULL for an empty slot
+    uint8_t *data;  // datagram as sent, header included
+    uint16_t len;   // datagram length
+} retx_entry_t;
+
+typedef struct retx_t
+{
+    retx_entry_t entry[RETX_HISTORY_DEPTH];
+    uint8_t depth;    // slots in use, RETX_HISTORY_MS of packets
+    uint8_t next;     // oldest slot, replaced next
+    uint32_t request; // indexes asked for
+    uint32_t resent;  // packets sent again
+    uint32_t miss;    // indexes no longer, or never, in the history
+} retx_t;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* History */
+/*! \brief Initialize history
+ *  \ingroup retx
+ *
+ * Size the history to RETX_HISTORY_MS of packets at the session rate, up to RETX_HISTORY_DEPTH.
+ *
+ * \param retx Retransmission state
+ * \param sample_rate Samples per second per channel
+ * \param frame_samples Samples per channel in a packet
+ */
+void retx_init(retx_t *retx, uint32_t sample_rate, uint16_t frame_samples);
+
+/*! \brief Keep a sent frame
+ *  \ingroup retx
+ *
+ * Take ownership of a frame after it was sent. The header written in front of the samples
+ * stays as sent, so a retransmission is the same datagram, RTP sequence number included.
+ * The oldest frame goes back to the pool.
+ *
+ * \param retx Retransmission state
+ * \param frame Sent frame
+ * \param data Start of the datagram
+ * \param len Datagram length
+ */
+void retx_keep(retx_t *retx, frame_t *frame, uint8_t *data, uint16_t len);
+
+/*! \brief Clear history
+ *  \ingroup retx
+ *
+ * Give every kept frame back to the pool.
+ *
+ * \param retx Retransmission state
+ */
+void retx_clear(retx_t *retx);
+
+/* NACK */
+/*! \brief Check for a NACK
+ *  \ingroup retx
+ *
+ * \param buf Received datagram
+ * \param len Datagram length
+ * \return 1 if the datagram is a NACK, 0 otherwise
+ */
+int8_t retx_is_nack(const uint8_t *buf, uint16_t len);
+
+/*! \brief Answer a NACK
+ *  \ingroup retx
+ *
+ * Send every requested packet still in the history back to the requester.
+ *
+ * \param retx Retransmission state
+ * \param sn UDP socket
+ * \param buf NACK datagram
+ * \param len NACK length
+ * \param addr Requester address
+ * \param port Requester port
+ * \return Number of packets sent again
+ */
+uint8_t retx_process(retx_t *retx, uint8_t sn, const uint8_t *buf, uint16_t len, uint8_t *addr, uint16_t port);
+
+#endif /* _RETX_H_ */
@@ -0,0 +1,300 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+
+#include "socket.h"
+#include "sntp.h"
+#include "rtp.h"
+
+#include "rtcp.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Header */
+#define RTCP_VERSION 2
+#define RTCP_HEADER_SIZE 4
+#define RTCP_SR_SIZE 28           // header, SSRC, NTP, RTP timestamp, packet and octet count
+#define RTCP_RR_SIZE 8            // header, SSRC
+#define RTCP_REPORT_BLOCK_SIZE 24
+
+/* SDES item */
+#define RTCP_SDES_END 0
+#define RTCP_SDES_CNAME 1
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Wallclock, NTP seconds at time_us_64() = g_rtcp_wall_us */
+static uint32_t g_rtcp_wall_sec = 0;
+static uint64_t g_rtcp_wall_us = 0;
+
+/* Compound packet */
+static uint8_t g_rtcp_buf[RTCP_BUF_SIZE] __attribute__((aligned(4)));
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+static void rtcp_put16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)value;
+}
+
+static void rtcp_put32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)(value >> 24);
+    p[1] = (uint8_t)(value >> 16);
+    p[2] = (uint8_t)(value >> 8);
+    p[3] = (uint8_t)value;
+}
+
+static uint32_t rtcp_get32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void rtcp_get_ntp(uint64_t time_us, uint32_t *sec, uint32_t *frac)
+{
+    uint64_t elapsed = time_us - g_rtcp_wall_us;
+
+    *sec = g_rtcp_wall_sec + (uint32_t)(elapsed / 1000000);
+    *frac = (uint32_t)(((elapsed % 1000000) << 32) / 1000000);
+}
+
+static void rtcp_put_header(uint8_t *p, uint8_t count, uint8_t type, uint16_t size)
+{
+    p[0] = (RTCP_VERSION << 6) | count;
+    p[1] = type;
+    rtcp_put16(p + 2, (size / 4) - 1);
+}
+
+static uint16_t rtcp_put_sdes(const rtcp_t *rtcp, uint8_t *p, uint32_t ssrc)
+{
+    uint16_t len = strlen(rtcp->cname);
+    uint16_t size;
+
+    /* Header, SSRC, CNAME item and at least one null octet ending the item list */
+    size = (RTCP_HEADER_SIZE + 4 + 2 + len + 1 + 3) & ~3u;
+    memset(p, 0, size);
+
+    rtcp_put_header(p, 1, RTCP_PT_SDES, size);
+    rtcp_put32(p + 4, ssrc);
+    p[8] = RTCP_SDES_CNAME;
+    p[9] = (uint8_t)len;
+    memcpy(p + 10, rtcp->cname, len);
+
+    return size;
+}
+
+static void rtcp_send_sr(rtcp_t *rtcp, uint64_t now_us)
+{
+    uint32_t ssrc, base;
+    uint32_t ntp_sec, ntp_frac;
+    uint32_t timestamp;
+    uint16_t size;
+
+    rtpGetStream(&ssrc, &base);
+
+    /* RTP timestamp of the same instant as the NTP timestamp, extrapolated from the last capture */
+    rtcp_get_ntp(now_us, &ntp_sec, &ntp_frac);
+    timestamp = base + (uint32_t)(rtcp->sync_index + ((now_us - rtcp->sync_time_us) * rtcp->clock_rate) / 1000000);
+
+    rtcp_put_header(g_rtcp_buf, 0, RTCP_PT_SR, RTCP_SR_SIZE);
+    rtcp_put32(g_rtcp_buf + 4, ssrc);
+    rtcp_put32(g_rtcp_buf + 8, ntp_sec);
+    rtcp_put32(g_rtcp_buf + 12, ntp_frac);
+    rtcp_put32(g_rtcp_buf + 16, timestamp);
+    rtcp_put32(g_rtcp_buf + 20, rtcp->packet_count);
+    rtcp_put32(g_rtcp_buf + 24, rtcp->octet_count);
+
+    size = RTCP_SR_SIZE + rtcp_put_sdes(rtcp, g_rtcp_buf + RTCP_SR_SIZE, ssrc);
+
+    sendto(rtcp->socket, g_rtcp_buf, size, rtcp->dest_ip, rtcp->port);
+}
+
+static int8_t rtcp_parse_block(rtcp_t *rtcp, const uint8_t *p, uint64_t now_us, uint32_t reporter)
+{
+    uint32_t ssrc, base;
+    uint32_t ntp_sec, ntp_frac;
+    uint32_t lsr, dlsr, arrival;
+    int32_t lost;
+
+    rtpGetStream(&ssrc, &base);
+
+    if (rtcp_get32(p) != ssrc)
+        return 0;
+
+    lost = (int32_t)(rtcp_get32(p + 4) << 8) >> 8;
+
+    rtcp->report.ssrc = reporter;
+    rtcp->report.fraction_lost = p[4];
+    rtcp->report.cumulative_lost = lost;
+    rtcp->report.highest_seq = rtcp_get32(p + 8);
+    rtcp->report.jitter = rtcp_get32(p + 12);
+    rtcp->report.jitter_us = (uint32_t)(((uint64_t)rtcp->report.jitter * 1000000) / rtcp->clock_rate);
+    rtcp->report.time_us = now_us;
+
+    /* RTT = arrival - LSR - DLSR, all in the middle 32 bits of the NTP timestamp */
+    lsr = rtcp_get32(p + 16);
+    dlsr = rtcp_get32(p + 20);
+    rtcp_get_ntp(now_us, &ntp_sec, &ntp_frac);
+    arrival = (ntp_sec << 16) | (ntp_frac >> 16);
+
+    if ((lsr != 0) && ((arrival - lsr) >= dlsr))
+        rtcp->report.rtt_us = (uint32_t)(((uint64_t)(arrival - lsr - dlsr) * 1000000) >> 16);
+
+    rtcp->report_count++;
+
+    return 1;
+}
+
+static int8_t rtcp_parse(rtcp_t *rtcp, const uint8_t *buf, uint16_t len, uint64_t now_us)
+{
+    uint16_t size, offset;
+    uint8_t count, i;
+    int8_t ret = 0;
+
+    /* Walk the compound packet, report blocks follow the sender info in SR and the SSRC in RR */
+    while (len >= RTCP_HEADER_SIZE)
+    {
+        if ((buf[0] >> 6) != RTCP_VERSION)
+            break;
+
+        size = (((uint16_t)buf[2] << 8) | buf[3]) * 4 + 4;
+
+        if (size > len)
+            break;
+
+        count = buf[0] & 0x1F;
+        offset = 0;
+
+        if (buf[1] == RTCP_PT_SR)
+            offset = RTCP_SR_SIZE;
+        else if (buf[1] == RTCP_PT_RR)
+            offset = RTCP_RR_SIZE;
+
+        if ((offset != 0) && (offset + count * RTCP_REPORT_BLOCK_SIZE <= size))
+        {
+            for (i = 0; i < count; i++)
+            {
+                if (rtcp_parse_block(rtcp, buf + offset + i * RTCP_REPORT_BLOCK_SIZE, now_us, rtcp_get32(buf + 4)))
+                    ret = 1;
+            }
+        }
+
+        buf += size;
+        len -= size;
+    }
+
+    return ret;
+}
+
+void rtcp_set_wallclock(uint32_t unix_sec)
+{
+    g_rtcp_wall_us = time_us_64();
+    g_rtcp_wall_sec = (uint32_t)TIME_LOCAL_TO_NTP((uint64_t)unix_sec);
+}
+
+int8_t rtcp_init(rtcp_t *rtcp, uint8_t sn, const uint8_t *dest_ip, uint16_t rtp_port, uint32_t clock_rate, const char *cname)
+{
+    memset(rtcp, 0, sizeof(rtcp_t));
+
+    rtcp->socket = sn;
+    memcpy(rtcp->dest_ip, dest_ip, 4);
+    rtcp->port = rtp_port + 1;
+    rtcp->clock_rate = clock_rate;
+    strncpy(rtcp->cname, cname, RTCP_CNAME_MAX_LEN);
+    rtcp->next_sr_us = time_us_64() + (RTCP_INTERVAL_MS * 1000);
+
+    /* Symmetric port, receivers send their reports back to where the sender reports came from */
+    close(sn);
+
+    if (socket(sn, Sn_MR_UDP, rtcp->port, SF_IO_NONBLOCK) != sn)
+        return -1;
+
+    return 0;
+}
+
+void rtcp_close(rtcp_t *rtcp)
+{
+    uint32_t ssrc, base;
+    uint16_t size;
+
+    if (getSn_SR(rtcp->socket) != SOCK_UDP)
+        return;
+
+    rtpGetStream(&ssrc, &base);
+
+    /* A compound packet starts with a report and carries the CNAME, BYE goes last */
+    rtcp_put_header(g_rtcp_buf, 0, RTCP_PT_RR, RTCP_RR_SIZE);
+    rtcp_put32(g_rtcp_buf + 4, ssrc);
+    size = RTCP_RR_SIZE + rtcp_put_sdes(rtcp, g_rtcp_buf + RTCP_RR_SIZE, ssrc);
+    rtcp_put_header(g_rtcp_buf + size, 1, RTCP_PT_BYE, 8);
+    rtcp_put32(g_rtcp_buf + size + 4, ssrc);
+    size += 8;
+
+    sendto(rtcp->socket, g_rtcp_buf, size, rtcp->dest_ip, rtcp->port);
+    close(rtcp->socket);
+}
+
+void rtcp_sent(rtcp_t *rtcp, uint64_t end_index, uint64_t time_us, uint16_t payload_len)
+{
+    rtcp->packet_count++;
+    rtcp->octet_count += payload_len;
+    rtcp->sync_index = end_index;
+    rtcp->sync_time_us = time_us;
+}
+
+int8_t rtcp_run(rtcp_t *rtcp)
+{
+    uint64_t now_us;
+    uint16_t size;
+    int32_t len;
+    uint8_t addr[4];
+    uint16_t port;
+    int8_t ret = 0;
+
+    if (getSn_SR(rtcp->socket) != SOCK_UDP)
+        return 0;
+
+    now_us = time_us_64();
+
+    if ((size = getSn_RX_RSR(rtcp->socket)) > 0)
+    {
+        if (size > RTCP_BUF_SIZE)
+            size = RTCP_BUF_SIZE;
+
+        len = recvfrom(rtcp->socket, g_rtcp_buf, size, addr, &port);
+
+        if (len > 0)
+            ret = rtcp_parse(rtcp, g_rtcp_buf, (uint16_t)len, now_us);
+    }
+
+    /* No report until there is something to map */
+    if ((rtcp->packet_count != 0) && ((int64_t)(now_us - rtcp->next_sr_us) >= 0))
+    {
+        rtcp->next_sr_us = now_us + (RTCP_INTERVAL_MS * 1000);
+        rtcp_send_sr(rtcp, now_us);
+    }
+
+    return ret;
+}
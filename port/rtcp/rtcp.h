@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _RTCP_H_
+#define _RTCP_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Packet type, RFC 3550 */
+#define RTCP_PT_SR 200
+#define RTCP_PT_RR 201
+#define RTCP_PT_SDES 202
+#define RTCP_PT_BYE 203
+
+/* Timing */
+#define RTCP_INTERVAL_MS 5000 // RFC 3550 minimum report interval
+
+/* Buffer */
+#define RTCP_BUF_SIZE 256    // one compound packet, SR + SDES or RR from a single receiver
+#define RTCP_CNAME_MAX_LEN 32
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+typedef struct rtcp_report_t
+{
+    uint32_t ssrc;            // reporting receiver
+    uint8_t fraction_lost;    // Q8, lost since the previous report
+    int32_t cumulative_lost;  // lost since the receiver started, 24-bit signed
+    uint32_t highest_seq;     // extended highest sequence number received
+    uint32_t jitter;          // interarrival jitter in RTP timestamp units
+    uint32_t jitter_us;       // same in us
+    uint32_t rtt_us;          // round trip through LSR/DLSR, 0 until the receiver echoes a sender report
+    uint64_t time_us;         // time_us_64() when the report arrived
+} rtcp_report_t;
+
+typedef struct rtcp_t
+{
+    /* Set by rtcp_init() */
+    uint8_t socket;                      // UDP socket for RTCP
+    uint8_t dest_ip[4];                  // same destination as RTP
+    uint16_t port;                       // RTP port + 1
+    uint32_t clock_rate;                 // RTP timestamp units per second
+    char cname[RTCP_CNAME_MAX_LEN + 1];  // SDES CNAME
+
+    /* Sender state */
+    uint32_t packet_count;    // RTP packets sent
+    uint32_t octet_count;     // RTP payload bytes sent
+    uint64_t sync_index;      // sample index captured at sync_time_us
+    uint64_t sync_time_us;    // capture time of the last sent frame
+    uint64_t next_sr_us;      // time_us_64() of the next sender report
+
+    /* Receiver feedback */
+    rtcp_report_t report;     // latest report block about this stream
+    uint32_t report_count;    // report blocks received
+} rtcp_t;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Wallclock */
+/*! \brief Set the wallclock
+ *  \ingroup rtcp
+ *
+ * Anchor the NTP timestamp in sender reports to a Unix time from SNTP, taken now.
+ * Until called, sender reports carry the time since boot, which still lets a receiver
+ * align streams from this device but not with other senders.
+ *
+ * \param unix_sec Seconds since 1970
+ */
+void rtcp_set_wallclock(uint32_t unix_sec);
+
+/* Session */
+/*! \brief Start RTCP for a stream
+ *  \ingroup rtcp
+ *
+ * Open the UDP socket on port + 1 and reset the counters. Call after rtpInit(), the
+ * SSRC and timestamp base are read from the RTP state on every report.
+ *
+ * \param rtcp RTCP state
+ * \param sn Socket number
+ * \param dest_ip RTP destination address
+ * \param rtp_port RTP destination port, RTCP uses rtp_port + 1
+ * \param clock_rate RTP timestamp units per second
+ * \param cname Canonical name, truncated to RTCP_CNAME_MAX_LEN
+ * \return 0 on success, -1 if the socket could not be opened
+ */
+int8_t rtcp_init(rtcp_t *rtcp, uint8_t sn, const uint8_t *dest_ip, uint16_t rtp_port, uint32_t clock_rate, const char *cname);
+
+/*! \brief Stop RTCP
+ *  \ingroup rtcp
+ *
+ * Send a BYE and close the socket.
+ *
+ * \param rtcp RTCP state
+ */
+void rtcp_close(rtcp_t *rtcp);
+
+/*! \brief Account a sent RTP packet
+ *  \ingroup rtcp
+ *
+ * \param rtcp RTCP state
+ * \param end_index Sample index just past the last sample captured at time_us
+ * \param time_us Capture time of a DMA frame holding samples of the packet
+ * \param payload_len RTP payload bytes
+ */
+void rtcp_sent(rtcp_t *rtcp, uint64_t end_index, uint64_t time_us, uint16_t payload_len);
+
+/*! \brief Run RTCP
+ *  \ingroup rtcp
+ *
+ * Send a sender report every RTCP_INTERVAL_MS and parse receiver reports.
+ * Call from the main loop while streaming.
+ *
+ * \param rtcp RTCP state
+ * \return 1 when a new report about this stream arrived, 0 otherwise
+ */
+int8_t rtcp_run(rtcp_t *rtcp);
+
+#endif /* _RTCP_H_ */
@@ -28,6 +28,7 @@
 #include "rtp.h"
 
 #define RTP_VERSION         2
+#define RTP_MARKER          0x80
 
 #define HTON32(H32)         (__builtin_bswap32(H32))
 #define HTON16(H16)         (__builtin_bswap16(H16))
@@ -68,6 +69,9 @@ static struct
 
     uint32_t ssrc;
 
+    /* Random timestamp base for rtpAddHeaderAt() */
+    uint32_t timestampBase;
+
 } rtpDataStore;
 
 StatusCode rtpGetRand(uint32_t *random)
@@ -104,6 +108,8 @@ StatusCode rtpInit(const rtpConfig *config)
         return status;
     }
 
+    rtpDataStore.timestampBase = rtpDataStore.periodicTimestamp;
+
     return STATUS_OK;
 }
 
@@ -137,3 +143,41 @@ StatusCode rtpAddHeader(uint8_t *data,
     return STATUS_OK;
 }
 
+StatusCode rtpAddHeaderAt(uint8_t *data,
+                          uint32_t length,
+                          uint32_t timestampOffset,
+                          uint8_t marker)
+{
+    rtpDataHeader *header = (rtpDataHeader*)data;
+
+    if (data == NULL || length < RTP_HEADER_LENGTH)
+    {
+        return STATUS_ERROR_API;
+    }
+
+    rtpDataStore.periodicTimestamp = rtpDataStore.timestampBase + timestampOffset;
+    rtpDataStore.sequenceNumber++;
+
+    header->verPadExCC          = RTP_VERSION << 6;
+    header->markerPayloadType   = rtpDataStore.config.payloadType |
+                                  (marker ? RTP_MARKER : 0);
+    header->timestamp           = HTON32(rtpDataStore.periodicTimestamp);
+    header->sequenceNumber      = HTON16(rtpDataStore.sequenceNumber);
+    header->ssrc                = HTON32(rtpDataStore.ssrc);
+
+    return STATUS_OK;
+}
+
+StatusCode rtpGetStream(uint32_t *ssrc,
+                        uint32_t *timestampBase)
+{
+    if (ssrc == NULL || timestampBase == NULL)
+    {
+        return STATUS_ERROR_API;
+    }
+
+    *ssrc = rtpDataStore.ssrc;
+    *timestampBase = rtpDataStore.timestampBase;
+
+    return STATUS_OK;
+}
@@ -78,5 +78,15 @@ StatusCode rtpInit(const rtpConfig *config);
 StatusCode rtpShutdown(void);
 StatusCode rtpAddHeader(uint8_t *data,
                        uint32_t length);
+/* Timestamp follows the sampling clock, offset from the random base chosen
+ * by rtpInit(). Samples lost before packetisation then show up as a
+ * timestamp jump without a sequence number gap. */
+StatusCode rtpAddHeaderAt(uint8_t *data,
+                          uint32_t length,
+                          uint32_t timestampOffset,
+                          uint8_t marker);
+/* SSRC and timestamp base of the stream set up by rtpInit(), for RTCP. */
+StatusCode rtpGetStream(uint32_t *ssrc,
+                        uint32_t *timestampBase);
 
 #endif /* Header Guard */
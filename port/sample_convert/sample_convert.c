@@ -0,0 +1,241 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <string.h>
+
+#include "sample_convert.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Samples are carried as signed 24-bit between gain and output */
+#define SAMPLE_CONVERT_S24_MAX 0x007FFFFF
+#define SAMPLE_CONVERT_S24_MIN (-0x00800000)
+
+/* Two raw words per 32-bit access */
+#define SAMPLE_CONVERT_PAIR_MASK 0x0FFF0FFF
+#define SAMPLE_CONVERT_PAIR_SIGN 0x08000800
+#define SAMPLE_CONVERT_PAIR_ERR 0x80008000
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+static inline int32_t sample_convert_clamp(int32_t value)
+{
+    if (value > SAMPLE_CONVERT_S24_MAX)
+        return SAMPLE_CONVERT_S24_MAX;
+    else if (value < SAMPLE_CONVERT_S24_MIN)
+        return SAMPLE_CONVERT_S24_MIN;
+
+    return value;
+}
+
+static inline uint8_t *sample_convert_put(uint8_t format, int32_t value, uint8_t *out)
+{
+    union
+    {
+        float f;
+        uint32_t u;
+    } f32;
+
+    switch (format)
+    {
+    case SAMPLE_CONVERT_S8:
+        *out++ = (uint8_t)(value >> 16);
+        break;
+    case SAMPLE_CONVERT_S16_LE:
+        *out++ = (uint8_t)(value >> 8);
+        *out++ = (uint8_t)(value >> 16);
+        break;
+    case SAMPLE_CONVERT_S16_BE:
+        *out++ = (uint8_t)(value >> 16);
+        *out++ = (uint8_t)(value >> 8);
+        break;
+    case SAMPLE_CONVERT_S24_LE:
+        *out++ = (uint8_t)value;
+        *out++ = (uint8_t)(value >> 8);
+        *out++ = (uint8_t)(value >> 16);
+        break;
+    case SAMPLE_CONVERT_F32_LE:
+        f32.f = (float)value * (1.0f / 8388608.0f);
+        *out++ = (uint8_t)f32.u;
+        *out++ = (uint8_t)(f32.u >> 8);
+        *out++ = (uint8_t)(f32.u >> 16);
+        *out++ = (uint8_t)(f32.u >> 24);
+        break;
+    default:
+        break;
+    }
+
+    return out;
+}
+
+/* Unity gain S16 from raw words, in and out must be 4-byte aligned.
+ * XOR of bit 11 turns offset binary into 12-bit two's complement (raw - 2048) in each
+ * half-word, and the shift by 4 scales both lanes to 16-bit without a carry between them.
+ */
+static uint32_t sample_convert_raw_s16_pair(sample_convert_t *conv, const uint16_t *in, uint32_t pairs, uint8_t *out)
+{
+    const uint32_t *src = (const uint32_t *)in;
+    uint32_t *dst = (uint32_t *)out;
+    uint32_t word;
+    uint32_t i;
+
+    for (i = 0; i < pairs; i++)
+    {
+        word = src[i];
+
+        if (word & SAMPLE_CONVERT_PAIR_ERR)
+        {
+            conv->err_count += ((word >> 15) & 1) + (word >> 31);
+
+            if (conv->err_mute)
+            {
+                if (word & SAMPLE_CONVERT_ADC_ERR)
+                    word = (word & 0xFFFF0000) | SAMPLE_CONVERT_ADC_CENTER;
+                if (word & ((uint32_t)SAMPLE_CONVERT_ADC_ERR << 16))
+                    word = (word & 0x0000FFFF) | ((uint32_t)SAMPLE_CONVERT_ADC_CENTER << 16);
+            }
+        }
+
+        word = ((word & SAMPLE_CONVERT_PAIR_MASK) ^ SAMPLE_CONVERT_PAIR_SIGN) << 4;
+
+        if (conv->format == SAMPLE_CONVERT_S16_BE)
+            word = ((word & 0x00FF00FF) << 8) | ((word >> 8) & 0x00FF00FF);
+
+        dst[i] = word;
+    }
+
+    return pairs * 4;
+}
+
+void sample_convert_init(sample_convert_t *conv, uint8_t format, uint16_t gain, bool err_mute)
+{
+    memset(conv, 0, sizeof(sample_convert_t));
+
+    conv->format = format;
+    conv->gain = gain;
+    conv->err_mute = err_mute;
+}
+
+uint8_t sample_convert_get_width(uint8_t format)
+{
+    switch (format)
+    {
+    case SAMPLE_CONVERT_S8:
+        return 1;
+    case SAMPLE_CONVERT_S16_LE:
+    case SAMPLE_CONVERT_S16_BE:
+        return 2;
+    case SAMPLE_CONVERT_S24_LE:
+        return 3;
+    case SAMPLE_CONVERT_F32_LE:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+uint32_t sample_convert_raw(sample_convert_t *conv, const uint16_t *in, uint32_t count, uint8_t *out)
+{
+    uint8_t *p = out;
+    uint16_t raw;
+    int32_t value;
+    uint32_t i = 0;
+
+    if ((conv->gain == SAMPLE_CONVERT_GAIN_UNITY) &&
+        ((conv->format == SAMPLE_CONVERT_S16_LE) || (conv->format == SAMPLE_CONVERT_S16_BE)) &&
+        ((((uintptr_t)in | (uintptr_t)out) & 3) == 0))
+    {
+        p += sample_convert_raw_s16_pair(conv, in, count / 2, out);
+        i = count & ~1u;
+    }
+
+    for (; i < count; i++)
+    {
+        raw = in[i];
+
+        if (raw & SAMPLE_CONVERT_ADC_ERR)
+        {
+            conv->err_count++;
+
+            if (conv->err_mute)
+                raw = SAMPLE_CONVERT_ADC_CENTER;
+        }
+
+        /* 12-bit x Q8 gain, then scale to 24-bit */
+        value = ((int32_t)(raw & SAMPLE_CONVERT_ADC_MASK) - SAMPLE_CONVERT_ADC_CENTER) * conv->gain;
+        value = sample_convert_clamp(value << 4);
+
+        p = sample_convert_put(conv->format, value, p);
+    }
+
+    return (uint32_t)(p - out);
+}
+
+uint32_t sample_convert_pcm(sample_convert_t *conv, const int16_t *in, uint32_t count, uint8_t *out)
+{
+    uint8_t *p = out;
+    int32_t value;
+    uint32_t i;
+
+    if ((conv->gain == SAMPLE_CONVERT_GAIN_UNITY) && (conv->format == SAMPLE_CONVERT_S16_LE))
+    {
+        /* Already the wire format on a little endian core */
+        memcpy(out, in, count * 2);
+
+        return count * 2;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        /* 16-bit x Q8 gain is already 24-bit */
+        value = sample_convert_clamp((int32_t)in[i] * conv->gain);
+
+        p = sample_convert_put(conv->format, value, p);
+    }
+
+    return (uint32_t)(p - out);
+}
+
+uint32_t sample_convert_s32(sample_convert_t *conv, const int32_t *in, uint32_t count, uint8_t *out)
+{
+    uint8_t *p = out;
+    int32_t value;
+    int64_t scaled;
+    uint32_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        value = in[i] >> 8;
+
+        /* 24-bit x Q8 gain needs 40 bits, skip it at unity */
+        if (conv->gain != SAMPLE_CONVERT_GAIN_UNITY)
+        {
+            scaled = ((int64_t)value * conv->gain) >> 8;
+
+            if (scaled > SAMPLE_CONVERT_S24_MAX)
+                scaled = SAMPLE_CONVERT_S24_MAX;
+            else if (scaled < SAMPLE_CONVERT_S24_MIN)
+                scaled = SAMPLE_CONVERT_S24_MIN;
+
+            value = (int32_t)scaled;
+        }
+
+        p = sample_convert_put(conv->format, value, p);
+    }
+
+    return (uint32_t)(p - out);
+}
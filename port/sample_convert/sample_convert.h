@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _SAMPLE_CONVERT_H_
+#define _SAMPLE_CONVERT_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Format */
+#define SAMPLE_CONVERT_S8 0     // signed 8-bit
+#define SAMPLE_CONVERT_S16_LE 1 // signed 16-bit little endian
+#define SAMPLE_CONVERT_S16_BE 2 // signed 16-bit big endian (RTP L16)
+#define SAMPLE_CONVERT_S24_LE 3 // signed 24-bit packed little endian
+#define SAMPLE_CONVERT_F32_LE 4 // float32 little endian, -1.0 ~ 1.0
+#define SAMPLE_CONVERT_FORMAT_MAX 4
+
+/* Gain */
+#define SAMPLE_CONVERT_GAIN_UNITY 256 // Q8
+
+/* Raw ADC word */
+#define SAMPLE_CONVERT_ADC_MASK 0x0FFF
+#define SAMPLE_CONVERT_ADC_CENTER 2048
+#define SAMPLE_CONVERT_ADC_ERR 0x8000
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+typedef struct sample_convert_t
+{
+    uint8_t format;     // SAMPLE_CONVERT_xxx
+    uint16_t gain;      // Q8, SAMPLE_CONVERT_GAIN_UNITY = 0dB
+    bool err_mute;      // output mid-scale for raw words with the ERR bit set
+    uint32_t err_count; // raw words seen with the ERR bit set
+} sample_convert_t;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Convert */
+/*! \brief Initialize converter
+ *  \ingroup sample_convert
+ *
+ * \param conv Converter
+ * \param format Output format (SAMPLE_CONVERT_xxx)
+ * \param gain Q8 gain, SAMPLE_CONVERT_GAIN_UNITY for none
+ * \param err_mute true to replace samples flagged with the ADC ERR bit by mid-scale
+ */
+void sample_convert_init(sample_convert_t *conv, uint8_t format, uint16_t gain, bool err_mute);
+
+/*! \brief Get sample width
+ *  \ingroup sample_convert
+ *
+ * \param format Output format (SAMPLE_CONVERT_xxx)
+ * \return Bytes per sample, 0 if the format is unknown
+ */
+uint8_t sample_convert_get_width(uint8_t format);
+
+/*! \brief Convert raw ADC words
+ *  \ingroup sample_convert
+ *
+ * Center raw 12-bit ADC words on mid-scale (2048), apply the gain and write them in the
+ * output format, scaled to the full range of the format.
+ * Unity gain S16 conversion of 4-byte aligned buffers runs two samples per 32-bit word.
+ *
+ * \param conv Converter
+ * \param in Raw ADC words
+ * \param count Number of words
+ * \param out Output buffer, room for count * sample_convert_get_width() bytes
+ * \return Number of bytes written
+ */
+uint32_t sample_convert_raw(sample_convert_t *conv, const uint16_t *in, uint32_t count, uint8_t *out);
+
+/*! \brief Convert 16-bit PCM
+ *  \ingroup sample_convert
+ *
+ * Apply the gain to full-scale signed 16-bit samples, such as the decimator output,
+ * and write them in the output format.
+ *
+ * \param conv Converter
+ * \param in Signed 16-bit samples
+ * \param count Number of samples
+ * \param out Output buffer, room for count * sample_convert_get_width() bytes
+ * \return Number of bytes written
+ */
+uint32_t sample_convert_pcm(sample_convert_t *conv, const int16_t *in, uint32_t count, uint8_t *out);
+
+/*! \brief Convert 32-bit PCM
+ *  \ingroup sample_convert
+ *
+ * Apply the gain to left-justified signed 32-bit samples, such as I2S slots or the PDM
+ * decimator output, and write them in the output format. The low 8 bits are dropped.
+ *
+ * \param conv Converter
+ * \param in Left-justified signed 32-bit samples
+ * \param count Number of samples
+ * \param out Output buffer, room for count * sample_convert_get_width() bytes
+ * \return Number of bytes written
+ */
+uint32_t sample_convert_s32(sample_convert_t *conv, const int32_t *in, uint32_t count, uint8_t *out);
+
+#endif /* _SAMPLE_CONVERT_H_ */
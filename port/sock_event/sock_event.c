@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "pico/binary_info.h"
+#include "hardware/gpio.h"
+
+#include "socket.h"
+
+#include "sock_event.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+static sock_event_callback_t g_sock_event_callback[_WIZCHIP_SOCK_NUM_];
+static uint8_t g_sock_event_mask[_WIZCHIP_SOCK_NUM_];
+static uint8_t g_sock_event_imr;
+static volatile uint32_t g_sock_event_edges;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+static void sock_event_irq(uint gpio, uint32_t events)
+{
+    if ((gpio == SOCK_EVENT_PIN_INT) && (events & GPIO_IRQ_EDGE_FALL))
+        g_sock_event_edges++;
+}
+
+void sock_event_initialize(void)
+{
+    uint8_t sn;
+
+    for (sn = 0; sn < _WIZCHIP_SOCK_NUM_; sn++)
+    {
+        g_sock_event_callback[sn] = NULL;
+        g_sock_event_mask[sn] = 0;
+    }
+
+    g_sock_event_imr = 0;
+    setIMR(g_sock_event_imr);
+
+    gpio_init(SOCK_EVENT_PIN_INT);
+    gpio_set_dir(SOCK_EVENT_PIN_INT, GPIO_IN);
+    gpio_pull_up(SOCK_EVENT_PIN_INT);
+    gpio_set_irq_enabled_with_callback(SOCK_EVENT_PIN_INT, GPIO_IRQ_EDGE_FALL, true, sock_event_irq);
+
+    bi_decl(bi_1pin_with_name(SOCK_EVENT_PIN_INT, "W5x00 INTn"));
+}
+
+void sock_event_register(uint8_t sn, uint8_t mask, sock_event_callback_t callback)
+{
+    if (sn >= _WIZCHIP_SOCK_NUM_)
+        return;
+
+    g_sock_event_callback[sn] = callback;
+    g_sock_event_mask[sn] = mask;
+
+    /* Events from before registering are not reported */
+    setSn_IMR(sn, mask);
+    setSn_IR(sn, mask);
+
+    g_sock_event_imr |= IMR_SOCK(sn);
+    setIMR(g_sock_event_imr);
+}
+
+void sock_event_unregister(uint8_t sn)
+{
+    if (sn >= _WIZCHIP_SOCK_NUM_)
+        return;
+
+    g_sock_event_imr &= ~IMR_SOCK(sn);
+    setIMR(g_sock_event_imr);
+
+    g_sock_event_callback[sn] = NULL;
+    g_sock_event_mask[sn] = 0;
+}
+
+uint8_t sock_event_dispatch(void)
+{
+    uint8_t ir;
+    uint8_t events;
+    uint8_t sn;
+    uint8_t pass;
+    uint8_t count = 0;
+
+    /* INTn is low as long as an unmasked bit is set, the socket API may have cleared it already */
+    for (pass = 0; (pass < SOCK_EVENT_PASS_MAX) && !gpio_get(SOCK_EVENT_PIN_INT); pass++)
+    {
+        ir = getIR() & g_sock_event_imr;
+
+        for (sn = 0; sn < _WIZCHIP_SOCK_NUM_; sn++)
+        {
+            if (!(ir & IR_SOCK(sn)))
+                continue;
+
+            events = getSn_IR(sn) & g_sock_event_mask[sn];
+            if (events == 0)
+                continue;
+
+            setSn_IR(sn, events);
+            if (g_sock_event_callback[sn] != NULL)
+            {
+                g_sock_event_callback[sn](sn, events);
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+uint32_t sock_event_get_edges(void)
+{
+    return g_sock_event_edges;
+}
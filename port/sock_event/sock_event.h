@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _SOCK_EVENT_H_
+#define _SOCK_EVENT_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+
+#include "wizchip_conf.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Pin */
+#ifndef SOCK_EVENT_PIN_INT
+#define SOCK_EVENT_PIN_INT 21 // W5100S INTn, active low
+#endif
+
+/* Event, the Sn_IR bits */
+#define SOCK_EVENT_CON Sn_IR_CON         // TCP connected
+#define SOCK_EVENT_DISCON Sn_IR_DISCON   // TCP FIN received from the peer
+#define SOCK_EVENT_RECV Sn_IR_RECV       // data in the RX buffer
+#define SOCK_EVENT_TIMEOUT Sn_IR_TIMEOUT // ARP or TCP retransmission timeout
+#define SOCK_EVENT_SENDOK Sn_IR_SENDOK   // SEND done
+
+/* Dispatch */
+#define SOCK_EVENT_PASS_MAX 4 // IR reads per dispatch while INTn stays low
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+typedef void (*sock_event_callback_t)(uint8_t sn, uint8_t events);
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Event */
+/*! \brief Initialize socket events
+ *  \ingroup sock_event
+ *
+ * Mask all chip interrupts and hook INTn to a falling edge GPIO IRQ.
+ * The IRQ only takes note of the edge, no SPI access is made from interrupt context.
+ */
+void sock_event_initialize(void);
+
+/*! \brief Register socket callback
+ *  \ingroup sock_event
+ *
+ * Unmask events of socket sn in Sn_IMR and the socket in IMR. The mask stays across
+ * socket() and close(). An event bit the dispatcher clears is gone for the socket API,
+ * so leave SOCK_EVENT_SENDOK and SOCK_EVENT_TIMEOUT out on sockets sent from with
+ * sendto() or send(), which wait for those bits themselves.
+ *
+ * \param sn Socket number
+ * \param mask SOCK_EVENT_xxx to report
+ * \param callback Called from sock_event_dispatch() with the events that happened
+ */
+void sock_event_register(uint8_t sn, uint8_t mask, sock_event_callback_t callback);
+
+/*! \brief Unregister socket callback
+ *  \ingroup sock_event
+ *
+ * \param sn Socket number
+ */
+void sock_event_unregister(uint8_t sn);
+
+/*! \brief Dispatch socket events
+ *  \ingroup sock_event
+ *
+ * Call from the main loop. Costs one GPIO read while INTn is high. Otherwise read IR once,
+ * then Sn_IR once for each socket it flags, clear the reported bits and call the callbacks.
+ *
+ * \return Number of callbacks made
+ */
+uint8_t sock_event_dispatch(void);
+
+/*! \brief Get INTn edge count
+ *  \ingroup sock_event
+ *
+ * \return Falling edges seen on INTn since initialization
+ */
+uint32_t sock_event_get_edges(void);
+
+#endif /* _SOCK_EVENT_H_ */
@@ -0,0 +1,160 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <string.h>
+
+#include "socket.h"
+
+#include "stream_dest.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+static const uint8_t g_stream_dest_broadcast[4] = {255, 255, 255, 255};
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+static int8_t stream_dest_open_mcast(stream_dest_t *dest, const stream_session_t *session)
+{
+    uint8_t mac[6];
+
+    /* 01:00:5e followed by the low 23 bits of the group, RFC 1112 */
+    mac[0] = 0x01;
+    mac[1] = 0x00;
+    mac[2] = 0x5E;
+    mac[3] = session->group[1] & 0x7F;
+    mac[4] = session->group[2];
+    mac[5] = session->group[3];
+
+    /* The group is taken from the destination registers at OPEN */
+    close(dest->mcast_socket);
+    setSn_DIPR(dest->mcast_socket, (uint8_t *)session->group);
+    setSn_DPORT(dest->mcast_socket, session->port);
+    setSn_DHAR(dest->mcast_socket, mac);
+
+    if (socket(dest->mcast_socket, Sn_MR_UDP, session->port, Sn_MR_MULTI) != dest->mcast_socket)
+        return -1;
+
+    setSn_TTL(dest->mcast_socket, session->ttl);
+
+    return 0;
+}
+
+int8_t stream_dest_open(stream_dest_t *dest, const stream_session_t *session, uint8_t sn, uint8_t mcast_sn, const uint8_t *requester)
+{
+    uint8_t i;
+
+    stream_dest_close(dest);
+    memset(dest, 0, sizeof(stream_dest_t));
+
+    dest->socket = sn;
+    dest->mcast_socket = mcast_sn;
+
+    switch (session->dest)
+    {
+    case STREAM_SESSION_DEST_UCAST:
+        memcpy(dest->ip[0], requester, 4);
+        dest->port[0] = session->port;
+        dest->count = 1;
+        memcpy(dest->report_ip, requester, 4);
+        break;
+
+    case STREAM_SESSION_DEST_MCAST:
+        if (stream_dest_open_mcast(dest, session) != 0)
+            return -1;
+
+        dest->socket = mcast_sn;
+        memcpy(dest->ip[0], session->group, 4);
+        dest->port[0] = session->port;
+        dest->count = 1;
+        memcpy(dest->report_ip, requester, 4);
+        break;
+
+    case STREAM_SESSION_DEST_LIST:
+        for (i = 0; i < session->sub_count; i++)
+        {
+            memcpy(dest->ip[i], session->sub_ip[i], 4);
+            dest->port[i] = (session->sub_port[i] != 0) ? session->sub_port[i] : session->port;
+        }
+
+        dest->count = session->sub_count;
+        memcpy(dest->report_ip, requester, 4);
+        break;
+
+    default:
+        memcpy(dest->ip[0], g_stream_dest_broadcast, 4);
+        dest->port[0] = session->port;
+        dest->count = 1;
+        memcpy(dest->report_ip, g_stream_dest_broadcast, 4);
+        break;
+    }
+
+    return 0;
+}
+
+void stream_dest_close(stream_dest_t *dest)
+{
+    /* SEND of the last datagrams may be left to the next poll, which never comes once count is 0 */
+    if (dest->count != 0)
+    {
+        while (sendto_async_pending(dest->socket) != 0)
+            sendto_async_poll(dest->socket);
+    }
+
+    if ((dest->socket == dest->mcast_socket) && (dest->count != 0))
+        close(dest->mcast_socket);
+
+    dest->count = 0;
+}
+
+uint8_t stream_dest_send(stream_dest_t *dest, uint8_t *buf, uint16_t len)
+{
+    wiz_IOVec vec;
+
+    vec.buf = buf;
+    vec.len = len;
+
+    return stream_dest_sendv(dest, &vec, 1);
+}
+
+uint8_t stream_dest_sendv(stream_dest_t *dest, wiz_IOVec *vec, uint8_t cnt)
+{
+    int32_t ret;
+    uint8_t sent = 0;
+    uint8_t i;
+
+    for (i = 0; i < dest->count; i++)
+    {
+        /* Only a full TX buffer waits, each try confirms what the chip has sent meanwhile */
+        do
+        {
+            ret = sendto_async(dest->socket, vec, cnt, dest->ip[i], dest->port[i]);
+        } while (ret == SOCK_BUSY);
+
+        if (ret > 0)
+            sent++;
+        else
+            dest->error++;
+    }
+
+    return sent;
+}
+
+void stream_dest_poll(stream_dest_t *dest)
+{
+    if (dest->count != 0)
+        sendto_async_poll(dest->socket);
+}
@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _STREAM_DEST_H_
+#define _STREAM_DEST_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+
+#include "stream_session.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Destination */
+#define STREAM_DEST_MAX STREAM_SESSION_SUB_MAX
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+typedef struct stream_dest_t
+{
+    uint8_t socket;                   // socket the stream leaves from
+    uint8_t mcast_socket;             // opened in multicast mode for dest=mcast, closed otherwise
+    uint8_t count;                    // destinations
+    uint8_t ip[STREAM_DEST_MAX][4];
+    uint16_t port[STREAM_DEST_MAX];
+    uint8_t report_ip[4];             // RTCP destination
+    uint32_t error;                   // datagrams not taken by the socket
+} stream_dest_t;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/*! \brief Open destinations
+ *  \ingroup stream_dest
+ *
+ * Resolve the session destination to a list of addresses. dest=ucast takes the requester,
+ * dest=mcast opens mcast_sn with Sn_MR_MULTI on the group, which sends the IGMP join.
+ * RTCP goes to the broadcast address for dest=bcast and to the requester otherwise,
+ * its socket is not in multicast mode.
+ *
+ * \param dest Destination state
+ * \param session Stream session
+ * \param sn UDP socket for broadcast and unicast
+ * \param mcast_sn Socket for multicast, free while streaming
+ * \param requester Address of the host that sent the start command
+ * \return 0 on success, -1 if the multicast socket could not be opened
+ */
+int8_t stream_dest_open(stream_dest_t *dest, const stream_session_t *session, uint8_t sn, uint8_t mcast_sn, const uint8_t *requester);
+
+/*! \brief Close destinations
+ *  \ingroup stream_dest
+ *
+ * Wait until the queued datagrams are sent, the last one of the stream included,
+ * then close the multicast socket, which leaves the group.
+ *
+ * \param dest Destination state
+ */
+void stream_dest_close(stream_dest_t *dest);
+
+/*! \brief Send a datagram to every destination
+ *  \ingroup stream_dest
+ *
+ * The same buffer goes to each destination, nothing is copied on the MCU side.
+ * SEND on the W5100S consumes the socket TX buffer, so each unicast subscriber costs
+ * one more write of the datagram into the chip. A multicast group costs one.
+ * Datagrams are queued with sendto_async() and only wait when the socket TX buffer is full.
+ *
+ * \param dest Destination state
+ * \param buf Datagram
+ * \param len Datagram length
+ * \return Number of destinations the datagram was sent to
+ */
+uint8_t stream_dest_send(stream_dest_t *dest, uint8_t *buf, uint16_t len);
+
+/*! \brief Send a datagram in pieces to every destination
+ *  \ingroup stream_dest
+ *
+ * Same as stream_dest_send() for a datagram split over several buffers, such as a header
+ * and the capture frame. The pieces are written into the socket TX buffer as they are,
+ * with one SPI frame per side of the TX ring wrap.
+ *
+ * \param dest Destination state
+ * \param vec Pieces of the datagram, in order
+ * \param cnt Number of pieces, up to WIZ_IOVEC_MAX
+ * \return Number of destinations the datagram was sent to
+ */
+uint8_t stream_dest_sendv(stream_dest_t *dest, wiz_IOVec *vec, uint8_t cnt);
+
+/*! \brief Confirm sent datagrams
+ *  \ingroup stream_dest
+ *
+ * Let the chip go on with the next queued datagram once the previous one is out.
+ * Call from the main loop, it costs one register read while a datagram is being sent.
+ *
+ * \param dest Destination state
+ */
+void stream_dest_poll(stream_dest_t *dest);
+
+#endif /* _STREAM_DEST_H_ */
@@ -0,0 +1,628 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/structs/rosc.h"
+
+#include "adc_capture.h"
+#include "frame_pool.h"
+#include "decimator.h"
+#include "pio_capture.h"
+#include "rtp.h"
+#include "fec.h"
+
+#include "stream_session.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Format names, indexed by SAMPLE_CONVERT_xxx */
+static const char *g_stream_session_format[SAMPLE_CONVERT_FORMAT_MAX + 1] =
+{
+    "s8",
+    "s16le",
+    "s16be",
+    "s24",
+    "f32",
+};
+
+/* Source names, indexed by CAPTURE_SOURCE_xxx */
+static const char *g_stream_session_source[CAPTURE_SOURCE_MAX + 1] =
+{
+    "adc",
+    "i2s",
+    "pdm",
+};
+
+/* The RTP header is written into the frame headroom */
+_Static_assert(RTP_HEADER_LENGTH <= FRAME_POOL_HEADROOM, "frame headroom too small for RTP");
+
+/* Protocol names, indexed by STREAM_SESSION_PROTO_xxx */
+static const char *g_stream_session_protocol[STREAM_SESSION_PROTO_MAX + 1] =
+{
+    "raw",
+    "rtp",
+};
+
+/* Destination names, indexed by STREAM_SESSION_DEST_xxx */
+static const char *g_stream_session_dest[STREAM_SESSION_DEST_MAX + 1] =
+{
+    "bcast",
+    "ucast",
+    "mcast",
+    "list",
+};
+
+/* ptime= keyword for a full datagram */
+static const char *g_stream_session_ptime_mtu[1] =
+{
+    "mtu",
+};
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+static int8_t stream_session_parse_name(const char *str, const char **names, uint8_t count, uint8_t *index)
+{
+    size_t len;
+    uint8_t i;
+
+    len = strcspn(str, " \r\n");
+
+    for (i = 0; i < count; i++)
+    {
+        if ((strlen(names[i]) == len) && (strncmp(str, names[i], len) == 0))
+        {
+            *index = i;
+
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+static int8_t stream_session_parse_value(const char *str, uint32_t *value)
+{
+    char *end;
+    unsigned long val;
+
+    val = strtoul(str, &end, 10);
+
+    if ((end == str) || ((*end != '\0') && (*end != ' ') && (*end != '\r') && (*end != '\n')))
+        return -1;
+
+    *value = (uint32_t)val;
+
+    return 0;
+}
+
+static int8_t stream_session_parse_ip(const char *str, uint8_t *ip, uint16_t *port)
+{
+    char *end;
+    unsigned long val;
+    uint8_t i;
+
+    for (i = 0; i < 4; i++)
+    {
+        val = strtoul(str, &end, 10);
+
+        if ((end == str) || (val > 255) || ((i < 3) && (*end != '.')))
+            return -1;
+
+        ip[i] = (uint8_t)val;
+        str = end + 1;
+    }
+
+    /* Optional ":<port>", only where the caller takes one */
+    if ((*end == ':') && (port != NULL))
+    {
+        str = end + 1;
+        val = strtoul(str, &end, 10);
+
+        if ((end == str) || (val == 0) || (val > 0xFFFF))
+            return -1;
+
+        *port = (uint16_t)val;
+    }
+
+    if ((*end != '\0') && (*end != ' ') && (*end != '\r') && (*end != '\n'))
+        return -1;
+
+    return 0;
+}
+
+void stream_session_default(stream_session_t *session)
+{
+    const uint8_t group[4] = STREAM_SESSION_DEFAULT_GROUP;
+
+    memset(session, 0, sizeof(stream_session_t));
+
+    session->port = STREAM_SESSION_DEFAULT_PORT;
+    session->sample_rate = STREAM_SESSION_DEFAULT_RATE;
+    session->frame_samples = STREAM_SESSION_DEFAULT_SAMPLES;
+    session->format = STREAM_SESSION_DEFAULT_FORMAT;
+    session->gain = STREAM_SESSION_DEFAULT_GAIN;
+    session->duration_ms = STREAM_SESSION_DEFAULT_TIME_MS;
+    session->oversample = STREAM_SESSION_DEFAULT_OVERSAMPLE;
+    session->header = STREAM_SESSION_DEFAULT_HEADER;
+    session->channels = STREAM_SESSION_DEFAULT_CHANNELS;
+    session->source = STREAM_SESSION_DEFAULT_SOURCE;
+    session->protocol = STREAM_SESSION_DEFAULT_PROTOCOL;
+    session->ptime = STREAM_SESSION_DEFAULT_PTIME;
+    session->fec = STREAM_SESSION_DEFAULT_FEC;
+    session->nack = STREAM_SESSION_DEFAULT_NACK;
+    session->dest = STREAM_SESSION_DEFAULT_DEST;
+    session->ttl = STREAM_SESSION_DEFAULT_TTL;
+    memcpy(session->group, group, 4);
+
+    stream_session_update(session);
+}
+
+int8_t stream_session_parse(stream_session_t *session, const char *cmd)
+{
+    stream_session_t temp;
+    const char *p;
+    uint32_t value;
+    uint8_t index;
+    uint8_t sub_given = 0;
+
+    if (strncmp(cmd, "start", 5) != 0)
+        return -1;
+
+    memcpy(&temp, session, sizeof(stream_session_t));
+    p = cmd + 5;
+
+    while (*p == ' ')
+        p++;
+
+    /* Port keeps the original "start <port>" form */
+    if ((*p >= '0') && (*p <= '9'))
+    {
+        if ((stream_session_parse_value(p, &value) != 0) || (value == 0) || (value > 0xFFFF))
+            return -1;
+
+        temp.port = (uint16_t)value;
+
+        while ((*p != '\0') && (*p != ' '))
+            p++;
+    }
+
+    while (*p != '\0')
+    {
+        while (*p == ' ')
+            p++;
+
+        if ((*p == '\0') || (*p == '\r') || (*p == '\n'))
+            break;
+
+        if (strncmp(p, "rate=", 5) == 0)
+        {
+            if (stream_session_parse_value(p + 5, &value) != 0)
+                return -1;
+
+            temp.sample_rate = value;
+        }
+        else if (strncmp(p, "samples=", 8) == 0)
+        {
+            if ((stream_session_parse_value(p + 8, &value) != 0) || (value == 0))
+                return -1;
+
+            temp.frame_samples = (uint16_t)value;
+        }
+        else if (strncmp(p, "bits=", 5) == 0)
+        {
+            if ((stream_session_parse_value(p + 5, &value) != 0) || ((value != 8) && (value != 16)))
+                return -1;
+
+            temp.format = (value == 8) ? SAMPLE_CONVERT_S8 : SAMPLE_CONVERT_S16_LE;
+        }
+        else if (strncmp(p, "fmt=", 4) == 0)
+        {
+            if (stream_session_parse_name(p + 4, g_stream_session_format, SAMPLE_CONVERT_FORMAT_MAX + 1, &temp.format) != 0)
+                return -1;
+        }
+        else if (strncmp(p, "gain=", 5) == 0)
+        {
+            if ((stream_session_parse_value(p + 5, &value) != 0) || (value == 0) || (value > 0xFFFF))
+                return -1;
+
+            temp.gain = (uint16_t)value;
+        }
+        else if (strncmp(p, "time=", 5) == 0)
+        {
+            if (stream_session_parse_value(p + 5, &value) != 0)
+                return -1;
+
+            temp.duration_ms = value;
+        }
+        else if (strncmp(p, "os=", 3) == 0)
+        {
+            if ((stream_session_parse_value(p + 3, &value) != 0) || ((value != 1) && (value != DECIMATOR_FACTOR)))
+                return -1;
+
+            temp.oversample = (uint8_t)value;
+        }
+        else if (strncmp(p, "src=", 4) == 0)
+        {
+            if (stream_session_parse_name(p + 4, g_stream_session_source, CAPTURE_SOURCE_MAX + 1, &temp.source) != 0)
+                return -1;
+        }
+        else if (strncmp(p, "ch=", 3) == 0)
+        {
+            if ((stream_session_parse_value(p + 3, &value) != 0) || (value == 0) || (value > ADC_CAPTURE_INPUT_COUNT))
+                return -1;
+
+            temp.channels = (uint8_t)value;
+        }
+        else if (strncmp(p, "hdr=", 4) == 0)
+        {
+            if ((stream_session_parse_value(p + 4, &value) != 0) || (value > 1))
+                return -1;
+
+            temp.header = (uint8_t)value;
+        }
+        else if (strncmp(p, "ptime=", 6) == 0)
+        {
+            if (stream_session_parse_name(p + 6, g_stream_session_ptime_mtu, 1, &index) == 0)
+                value = STREAM_SESSION_PTIME_MTU;
+            else if ((stream_session_parse_value(p + 6, &value) != 0) || (value >= STREAM_SESSION_PTIME_MTU))
+                return -1;
+
+            temp.ptime = (uint16_t)value;
+        }
+        else if (strncmp(p, "fec=", 4) == 0)
+        {
+            if ((stream_session_parse_value(p + 4, &value) != 0) || (value == 1) || (value > FEC_GROUP_MAX))
+                return -1;
+
+            temp.fec = (uint8_t)value;
+        }
+        else if (strncmp(p, "nack=", 5) == 0)
+        {
+            if ((stream_session_parse_value(p + 5, &value) != 0) || (value > 1))
+                return -1;
+
+            temp.nack = (uint8_t)value;
+        }
+        else if (strncmp(p, "dest=", 5) == 0)
+        {
+            if (stream_session_parse_name(p + 5, g_stream_session_dest, STREAM_SESSION_DEST_MAX + 1, &temp.dest) != 0)
+                return -1;
+        }
+        else if (strncmp(p, "group=", 6) == 0)
+        {
+            /* 224.0.0.0/4 */
+            if ((stream_session_parse_ip(p + 6, temp.group, NULL) != 0) || ((temp.group[0] & 0xF0) != 0xE0))
+                return -1;
+        }
+        else if (strncmp(p, "ttl=", 4) == 0)
+        {
+            if ((stream_session_parse_value(p + 4, &value) != 0) || (value == 0) || (value > 255))
+                return -1;
+
+            temp.ttl = (uint8_t)value;
+        }
+        else if (strncmp(p, "sub=", 4) == 0)
+        {
+            /* The first sub= of a command starts a new list */
+            if (!sub_given)
+                temp.sub_count = 0;
+
+            sub_given = 1;
+
+            if (temp.sub_count >= STREAM_SESSION_SUB_MAX)
+                return -1;
+
+            temp.sub_port[temp.sub_count] = 0;
+
+            if (stream_session_parse_ip(p + 4, temp.sub_ip[temp.sub_count], &temp.sub_port[temp.sub_count]) != 0)
+                return -1;
+
+            temp.sub_count++;
+        }
+        else if (strncmp(p, "proto=", 6) == 0)
+        {
+            if (stream_session_parse_name(p + 6, g_stream_session_protocol, STREAM_SESSION_PROTO_MAX + 1, &temp.protocol) != 0)
+                return -1;
+        }
+        else
+        {
+            return -1;
+        }
+
+        while ((*p != '\0') && (*p != ' '))
+            p++;
+    }
+
+    /* Parity needs the timing header, refuse it rather than switch it off for this and every later start */
+    if (temp.fec && ((temp.protocol != STREAM_SESSION_PROTO_RAW) || !temp.header))
+        return -1;
+
+    /* NACKs are only read on the unicast data socket, a multicast stream would never be resent */
+    if (temp.nack && (temp.dest == STREAM_SESSION_DEST_MCAST))
+        return -1;
+
+    stream_session_update(&temp);
+    memcpy(session, &temp, sizeof(stream_session_t));
+
+    return 0;
+}
+
+static uint32_t stream_session_update_adc(stream_session_t *session)
+{
+    if ((session->channels == 0) || (session->channels > ADC_CAPTURE_INPUT_COUNT))
+        session->channels = 1;
+
+    /* One decimator, oversampling is single channel only */
+    if ((session->oversample != DECIMATOR_FACTOR) || (session->channels > 1))
+        session->oversample = 1;
+
+    /* The ADC rate is shared by all round-robin channels */
+    if (session->sample_rate < STREAM_SESSION_RATE_MIN)
+        session->sample_rate = STREAM_SESSION_RATE_MIN;
+    else if (session->sample_rate > STREAM_SESSION_RATE_MAX / (session->oversample * session->channels))
+        session->sample_rate = STREAM_SESSION_RATE_MAX / (session->oversample * session->channels);
+
+    /* 48MHz / (1 + clkdiv), clkdiv has 8 fractional bits */
+    session->clkdiv = ((float)ADC_CAPTURE_CLK_HZ / (float)(session->sample_rate * session->oversample * session->channels)) - 1.0f;
+
+    if (session->clkdiv < ADC_CAPTURE_CLKDIV_MIN)
+        session->clkdiv = ADC_CAPTURE_CLKDIV_MIN;
+
+    session->clkdiv = (float)((uint32_t)(session->clkdiv * 256.0f)) / 256.0f;
+    session->actual_rate = (uint32_t)((float)ADC_CAPTURE_CLK_HZ / ((1.0f + session->clkdiv) * session->oversample * session->channels) + 0.5f);
+
+    return ADC_CAPTURE_FRAME_SAMPLES_MAX / session->channels;
+}
+
+static uint32_t stream_session_update_pio(stream_session_t *session)
+{
+    /* I2S is captured as stereo and may drop the right slot, PDM is mono */
+    if ((session->channels == 0) || (session->channels > 2) || (session->source == CAPTURE_SOURCE_PDM))
+        session->channels = 1;
+
+    session->oversample = 1;
+
+    if (session->sample_rate < STREAM_SESSION_PIO_RATE_MIN)
+        session->sample_rate = STREAM_SESSION_PIO_RATE_MIN;
+    else if (session->sample_rate > STREAM_SESSION_PIO_RATE_MAX)
+        session->sample_rate = STREAM_SESSION_PIO_RATE_MAX;
+
+    /* The PIO divider is set by the backend, RTP and RTCP clocks follow its rounding */
+    session->clkdiv = 0;
+    session->actual_rate = pio_capture_get_rate((session->source == CAPTURE_SOURCE_PDM) ? PIO_CAPTURE_MODE_PDM : PIO_CAPTURE_MODE_I2S,
+                                                session->sample_rate);
+
+    if (session->source == CAPTURE_SOURCE_PDM)
+        return PIO_CAPTURE_FRAME_WORDS_MAX / (DECIMATOR_PDM_FACTOR / 32);
+
+    return PIO_CAPTURE_FRAME_WORDS_MAX / 2;
+}
+
+void stream_session_update(stream_session_t *session)
+{
+    uint32_t max_samples;
+    uint32_t capture_max;
+    uint32_t group_size;
+    uint32_t frames;
+    uint32_t capture_groups;
+    uint64_t samples;
+
+    if (session->source > CAPTURE_SOURCE_MAX)
+        session->source = CAPTURE_SOURCE_ADC;
+
+    if (session->source == CAPTURE_SOURCE_ADC)
+        capture_max = stream_session_update_adc(session);
+    else
+        capture_max = stream_session_update_pio(session);
+
+    if (session->protocol > STREAM_SESSION_PROTO_MAX)
+        session->protocol = STREAM_SESSION_PROTO_RAW;
+
+    /* L16 is network byte order */
+    if (session->protocol == STREAM_SESSION_PROTO_RTP)
+        session->format = SAMPLE_CONVERT_S16_BE;
+    else if (session->format > SAMPLE_CONVERT_FORMAT_MAX)
+        session->format = STREAM_SESSION_DEFAULT_FORMAT;
+
+    /* Parity rebuilds lost packets with their timing header, the host has no other way to place them */
+    if ((session->protocol != STREAM_SESSION_PROTO_RAW) || !session->header || (session->fec > FEC_GROUP_MAX))
+        session->fec = 0;
+
+    if ((session->actual_rate == 44100) && (session->channels <= 2))
+        session->payload_type = (session->channels == 1) ? STREAM_SESSION_RTP_PT_L16_MONO : STREAM_SESSION_RTP_PT_L16_STEREO;
+    else
+        session->payload_type = STREAM_SESSION_RTP_PT_DYNAMIC;
+
+    if (session->gain == 0)
+        session->gain = STREAM_SESSION_DEFAULT_GAIN;
+
+    if (session->dest > STREAM_SESSION_DEST_MAX)
+        session->dest = STREAM_SESSION_DEFAULT_DEST;
+
+    if (session->sub_count > STREAM_SESSION_SUB_MAX)
+        session->sub_count = 0;
+
+    if ((session->dest == STREAM_SESSION_DEST_LIST) && (session->sub_count == 0))
+        session->dest = STREAM_SESSION_DEST_UCAST;
+
+    if (session->ttl == 0)
+        session->ttl = STREAM_SESSION_DEFAULT_TTL;
+
+    session->bit_depth = sample_convert_get_width(session->format) * 8;
+    group_size = (session->bit_depth / 8) * session->channels;
+
+    /* The header shares the datagram with the samples */
+    if (session->protocol == STREAM_SESSION_PROTO_RTP)
+        max_samples = (STREAM_SESSION_DATAGRAM_MAX - RTP_HEADER_LENGTH) / group_size;
+    else if (session->fec)
+        max_samples = (STREAM_SESSION_DATAGRAM_MAX - STREAM_SESSION_HEADER_SIZE - FEC_HEADER_SIZE) / group_size;
+    else if (session->header)
+        max_samples = (STREAM_SESSION_DATAGRAM_MAX - STREAM_SESSION_HEADER_SIZE) / group_size;
+    else
+        max_samples = STREAM_SESSION_DATAGRAM_MAX / group_size;
+
+    if (max_samples > FRAME_POOL_FRAME_SIZE / group_size)
+        max_samples = FRAME_POOL_FRAME_SIZE / group_size;
+
+    /* Clamp before narrowing, a long ptime must not wrap to a short packet */
+    if (session->ptime == STREAM_SESSION_PTIME_MTU)
+        samples = max_samples;
+    else if (session->ptime != 0)
+        samples = ((uint64_t)session->actual_rate * session->ptime) / 1000;
+    else
+        samples = session->frame_samples;
+
+    if (samples == 0)
+        samples = 1;
+    else if (samples > max_samples)
+        samples = max_samples;
+
+    session->frame_samples = (uint16_t)samples;
+
+    session->packet_size = session->frame_samples * group_size;
+
+    /* Split a packet into equal DMA frames no larger than the capture buffer, the packetizer joins them back */
+    frames = (session->frame_samples + capture_max - 1) / capture_max;
+    capture_groups = (session->frame_samples + frames - 1) / frames;
+
+    /* DMA frame elements, oversampled frames are decimated in whole DMA frames */
+    if (session->source == CAPTURE_SOURCE_I2S)
+        session->capture_samples = capture_groups * 2;
+    else if (session->source == CAPTURE_SOURCE_PDM)
+        session->capture_samples = capture_groups * (DECIMATOR_PDM_FACTOR / 32);
+    else if (session->oversample > 1)
+        session->capture_samples = ADC_CAPTURE_FRAME_SAMPLES_MAX;
+    else
+        session->capture_samples = capture_groups * session->channels;
+
+    /* time=0 streams until stopped */
+    if (session->duration_ms == 0)
+    {
+        session->packet_limit = 0;
+
+        return;
+    }
+
+    session->packet_limit = (uint32_t)(((uint64_t)session->duration_ms * session->actual_rate) / (1000 * (uint64_t)session->frame_samples));
+
+    if (session->packet_limit == 0)
+        session->packet_limit = 1;
+}
+
+static StatusCode stream_session_get_random(uint32_t *random)
+{
+    uint32_t value = 0;
+    uint8_t i, j;
+
+    /* ROSC jitter, each bit folds several reads as consecutive ones are correlated */
+    for (i = 0; i < 32; i++)
+    {
+        for (j = 0; j < 8; j++)
+            value ^= (rosc_hw->randombit & 1u) << i;
+
+        busy_wait_us_32(1);
+    }
+
+    *random = value ^ time_us_32();
+
+    return STATUS_OK;
+}
+
+int8_t stream_session_begin(const stream_session_t *session)
+{
+    rtpConfig config;
+
+    if (session->protocol != STREAM_SESSION_PROTO_RTP)
+        return 0;
+
+    config.periodicTimestampIncr = session->frame_samples;
+    config.payloadType = session->payload_type;
+    config.getRandomCb = stream_session_get_random;
+
+    rtpShutdown();
+
+    if (rtpInit(&config) != STATUS_OK)
+        return -1;
+
+    printf(" SDP: m=audio %d RTP/AVP %d\n", session->port, session->payload_type);
+    printf(" SDP: a=rtpmap:%d L16/%lu/%d\n", session->payload_type, (unsigned long)session->actual_rate, session->channels);
+
+    return 0;
+}
+
+uint8_t *stream_session_put_header(const stream_session_t *session, frame_t *frame, uint8_t first, uint16_t *len)
+{
+    uint8_t *p;
+    uint8_t i;
+
+    /* The RTP clock is the sampling clock, a lost frame moves the timestamp but not the sequence number */
+    if (session->protocol == STREAM_SESSION_PROTO_RTP)
+    {
+        p = frame->data - RTP_HEADER_LENGTH;
+        *len = frame->len + RTP_HEADER_LENGTH;
+
+        rtpAddHeaderAt(p, *len, (uint32_t)frame->sample_index, first);
+
+        return p;
+    }
+
+    if (!session->header)
+    {
+        *len = frame->len;
+
+        return frame->data;
+    }
+
+    p = frame->data - STREAM_SESSION_HEADER_SIZE;
+
+    for (i = 0; i < 8; i++)
+    {
+        p[i] = (uint8_t)(frame->sample_index >> (56 - (i * 8)));
+        p[i + 8] = (uint8_t)(frame->timestamp_us >> (56 - (i * 8)));
+    }
+
+    *len = frame->len + STREAM_SESSION_HEADER_SIZE;
+
+    return p;
+}
+
+void stream_session_print(const stream_session_t *session)
+{
+    printf(" port %d, %s, %s, %s, rate %d x %d (clkdiv %d.%02d), %d samples x %d ch x %s (gain %d/256) = %d bytes, %lu pkt/s, %d ms (%d packets)%s, fec %d%s\n",
+           session->port,
+           g_stream_session_dest[session->dest],
+           g_stream_session_protocol[session->protocol],
+           g_stream_session_source[session->source],
+           session->actual_rate,
+           session->oversample,
+           (int)session->clkdiv, (int)((session->clkdiv - (int)session->clkdiv) * 100),
+           session->frame_samples,
+           session->channels,
+           g_stream_session_format[session->format],
+           session->gain,
+           session->packet_size,
+           (unsigned long)((session->actual_rate + session->frame_samples / 2) / session->frame_samples),
+           session->duration_ms,
+           session->packet_limit,
+           (session->header && (session->protocol == STREAM_SESSION_PROTO_RAW)) ? ", header" : "",
+           session->fec,
+           session->nack ? ", nack" : "");
+}
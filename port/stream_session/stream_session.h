@@ -0,0 +1,205 @@
+/**
+ * Copyright (c) 2022 WIZnet Co.,Ltd
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _STREAM_SESSION_H_
+#define _STREAM_SESSION_H_
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Includes
+  * ----------------------------------------------------------------------------------------------------
+  */
+#include <stdint.h>
+
+#include "sample_convert.h"
+#include "frame_pool.h"
+#include "capture_source.h"
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Macros
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Default */
+#define STREAM_SESSION_DEFAULT_PORT 30001
+#define STREAM_SESSION_DEFAULT_RATE 16000
+#define STREAM_SESSION_DEFAULT_SAMPLES 250
+#define STREAM_SESSION_DEFAULT_FORMAT SAMPLE_CONVERT_S16_LE
+#define STREAM_SESSION_DEFAULT_GAIN SAMPLE_CONVERT_GAIN_UNITY
+#define STREAM_SESSION_DEFAULT_TIME_MS 31250 // 2000 packets of 250 samples at 16kS/s
+#define STREAM_SESSION_DEFAULT_OVERSAMPLE 1
+#define STREAM_SESSION_DEFAULT_HEADER 1
+#define STREAM_SESSION_DEFAULT_CHANNELS 1
+#define STREAM_SESSION_DEFAULT_SOURCE CAPTURE_SOURCE_ADC
+#define STREAM_SESSION_DEFAULT_PROTOCOL STREAM_SESSION_PROTO_RAW
+#define STREAM_SESSION_DEFAULT_PTIME 0 // packet size from samples=
+#define STREAM_SESSION_DEFAULT_FEC 0   // no parity packets
+#define STREAM_SESSION_DEFAULT_NACK 0  // no retransmission history
+#define STREAM_SESSION_DEFAULT_DEST STREAM_SESSION_DEST_BCAST
+#define STREAM_SESSION_DEFAULT_GROUP {239, 255, 0, 1} // organization-local scope
+#define STREAM_SESSION_DEFAULT_TTL 1                  // multicast stays on the local segment
+
+/* Protocol */
+#define STREAM_SESSION_PROTO_RAW 0 // bare samples, optionally behind the timing header
+#define STREAM_SESSION_PROTO_RTP 1 // RTP/AVP L16, RFC 3551
+#define STREAM_SESSION_PROTO_MAX 1
+
+/* Destination */
+#define STREAM_SESSION_DEST_BCAST 0 // 255.255.255.255, every host on the segment
+#define STREAM_SESSION_DEST_UCAST 1 // the host that sent the start command
+#define STREAM_SESSION_DEST_MCAST 2 // IPv4 multicast group
+#define STREAM_SESSION_DEST_LIST 3  // unicast to each subscriber
+#define STREAM_SESSION_DEST_MAX 3
+#define STREAM_SESSION_SUB_MAX 4    // subscribers in the list
+
+/* RTP payload type, L16 has static types at 44.1kHz only */
+#define STREAM_SESSION_RTP_PT_L16_STEREO 10
+#define STREAM_SESSION_RTP_PT_L16_MONO 11
+#define STREAM_SESSION_RTP_PT_DYNAMIC 96
+
+/* Header, big endian 64-bit sample index then 64-bit capture time in us */
+#define STREAM_SESSION_HEADER_SIZE 16
+
+/* Packet */
+#define STREAM_SESSION_DATAGRAM_MAX 1472  // UDP payload in a 1500-byte MTU, header included
+#define STREAM_SESSION_PTIME_MTU 0xFFFF   // fill each datagram up to STREAM_SESSION_DATAGRAM_MAX
+
+/* Limit */
+#define STREAM_SESSION_RATE_MIN 1000
+#define STREAM_SESSION_RATE_MAX 500000 // ADC rate, output rate is divided by the oversampling factor
+#define STREAM_SESSION_PIO_RATE_MIN 8000 // I2S and PDM
+#define STREAM_SESSION_PIO_RATE_MAX 96000
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Variables
+  * ----------------------------------------------------------------------------------------------------
+  */
+typedef struct stream_session_t
+{
+    /* Requested by the control command */
+    uint16_t port;            // UDP destination port
+    uint8_t source;           // CAPTURE_SOURCE_xxx
+    uint32_t sample_rate;     // requested samples per second
+    uint16_t frame_samples;   // samples per channel per packet
+    uint8_t channels;         // ADC inputs 0 ~ channels - 1, interleaved on the wire
+    uint8_t format;           // SAMPLE_CONVERT_xxx on the wire
+    uint16_t gain;            // Q8, SAMPLE_CONVERT_GAIN_UNITY = 0dB
+    uint32_t duration_ms;     // stream time, 0 for continuous
+    uint8_t oversample;       // 1 or DECIMATOR_FACTOR
+    uint8_t header;           // 1 to send STREAM_SESSION_HEADER_SIZE bytes of timing in front of each packet
+    uint8_t protocol;         // STREAM_SESSION_PROTO_xxx
+    uint16_t ptime;           // packet duration in ms, STREAM_SESSION_PTIME_MTU, 0 to use frame_samples
+    uint8_t fec;              // data packets per XOR parity packet, 0 for off
+    uint8_t nack;             // 1 to keep sent frames and answer NACKs on the data socket
+    uint8_t dest;             // STREAM_SESSION_DEST_xxx
+    uint8_t group[4];         // multicast group
+    uint8_t ttl;              // multicast time to live
+    uint8_t sub_count;        // subscribers in the list
+    uint8_t sub_ip[STREAM_SESSION_SUB_MAX][4];
+    uint16_t sub_port[STREAM_SESSION_SUB_MAX];
+
+    /* Derived by stream_session_update() */
+    float clkdiv;             // ADC clock divider, 0 for PIO sources
+    uint32_t actual_rate;     // output samples per second after clkdiv rounding
+    uint8_t bit_depth;        // bits per sample on the wire
+    uint16_t capture_samples; // elements per DMA frame, all channels, a packet may take several
+    uint16_t packet_size;     // payload bytes per packet
+    uint32_t packet_limit;    // packets to send before stopping, 0 for continuous
+    uint8_t payload_type;     // RTP payload type
+} stream_session_t;
+
+/**
+  * ----------------------------------------------------------------------------------------------------
+  * Functions
+  * ----------------------------------------------------------------------------------------------------
+  */
+/* Session */
+/*! \brief Set session defaults
+ *  \ingroup stream_session
+ *
+ * 16kS/s, 250 samples of 16 bits per packet, about 31 seconds.
+ *
+ * \param session Stream session
+ */
+void stream_session_default(stream_session_t *session);
+
+/*! \brief Parse start command
+ *  \ingroup stream_session
+ *
+ * Parse "start <port> [rate=<S/s>] [samples=<n>] [bits=<8|16>] [fmt=<s8|s16le|s16be|s24|f32>]
+ * [gain=<Q8>] [time=<ms>] [os=<1|8>] [ch=<1..4>] [src=<adc|i2s|pdm>] [hdr=<0|1>] [proto=<raw|rtp>]
+ * [ptime=<ms|mtu|0>] [fec=<0|2..16>] [nack=<0|1>] [dest=<bcast|ucast|mcast|list>] [group=<a.b.c.d>]
+ * [ttl=<1..255>] [sub=<a.b.c.d>[:<port>]]".
+ * bits=8 and bits=16 select s8 and s16le. gain is in 1/256 steps, 256 for 0dB.
+ * With os=8 the ADC runs at 8 x rate and the decimator brings it back down to rate.
+ * ch=n captures ADC inputs 0 ~ n-1 in round-robin, rate is per channel and os=8 is single channel only.
+ * src=i2s takes ch=1 (left) or ch=2, src=pdm is mono. Both run at 8 ~ 96kS/s without oversampling.
+ * hdr=0 sends bare samples without the timing header. time=0 streams until "stop".
+ * proto=rtp sends RTP/L16, which is always s16be and replaces the timing header.
+ * ptime=<ms> sizes packets by duration and ptime=mtu fills each datagram up to 1472 bytes,
+ * both override samples=. ptime=0 goes back to samples=.
+ * fec=n sends an XOR parity packet after every n data packets. It needs the timing header,
+ * so a command that leaves it on with hdr=0 or proto=rtp is invalid.
+ * nack=1 keeps the packets of the last RETX_HISTORY_MS, up to RETX_HISTORY_DEPTH, and resends them when asked by a NACK.
+ * The NACKs come in on the data socket, so nack=1 with dest=mcast is invalid.
+ * dest=ucast sends to the host of the control connection, dest=mcast to group= with ttl=,
+ * dest=list to every sub=. sub= may be given up to STREAM_SESSION_SUB_MAX times and replaces
+ * the previous list, the port defaults to the stream port. dest=list without subscribers is ucast.
+ * Options not given keep their previous value. The session is only updated
+ * when the whole command is valid.
+ *
+ * \param session Stream session
+ * \param cmd Null-terminated command string
+ * \return 0 on success, -1 on invalid command or option
+ */
+int8_t stream_session_parse(stream_session_t *session, const char *cmd);
+
+/*! \brief Update derived values
+ *  \ingroup stream_session
+ *
+ * Clamp the requested values to what the ADC and frame pool support and
+ * recompute the ADC clock divider, packet size, packet limit and RTP payload type.
+ *
+ * \param session Stream session
+ */
+void stream_session_update(stream_session_t *session);
+
+/*! \brief Begin a stream
+ *  \ingroup stream_session
+ *
+ * Call once per fresh start, not on resume. In RTP mode pick a new SSRC, sequence number
+ * and timestamp base from the ring oscillator and print the matching SDP lines.
+ *
+ * \param session Stream session
+ * \return 0 on success, -1 if the RTP state could not be set up
+ */
+int8_t stream_session_begin(const stream_session_t *session);
+
+/*! \brief Build packet header
+ *  \ingroup stream_session
+ *
+ * Write the frame sample index and capture time, or the RTP header, into the frame
+ * headroom directly in front of the samples. The RTP timestamp is the frame sample index
+ * from the random base. A session attached to a running capture starts at a later sample index,
+ * so the caller says which packet is its first and gets the marker bit.
+ *
+ * \param session Stream session
+ * \param frame Frame to send
+ * \param first 1 for the first packet the session sends
+ * \param len Set to the number of bytes to send
+ * \return Start of the packet
+ */
+uint8_t *stream_session_put_header(const stream_session_t *session, frame_t *frame, uint8_t first, uint16_t *len);
+
+/*! \brief Print session
+ *  \ingroup stream_session
+ *
+ * \param session Stream session
+ */
+void stream_session_print(const stream_session_t *session);
+
+#endif /* _STREAM_SESSION_H_ */
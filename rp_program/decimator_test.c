@@ -0,0 +1,195 @@
+//--------------------------------------------------------------
+// file Name : decimator_test.c
+// host reference test for port/decimator, the os=8 capture filter
+// command : cc -O2 -I../port/decimator -o decimator_test decimator_test.c -lm
+// run : ./decimator_test, exit status 0 when every check passes
+//--------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+//built in here so the reference uses the same coefficient table
+#include "decimator.c"
+
+#define OUT_COUNT     8192                              //output samples per tone
+#define IN_COUNT      (OUT_COUNT * DECIMATOR_FACTOR)
+#define SETTLE        (DECIMATOR_FIR_TAPS * 2)          //outputs skipped before measuring
+#define TONE_AMP      2000.0                            //ADC counts around mid-scale
+#define FULL_SCALE    (TONE_AMP * 16)                   //the same tone at the 16-bit output
+
+#define REF_MAX_ERR   6.0     //LSB, 15-bit FIR input and Q15 rounding
+#define REF_RMS_ERR   1.5     //LSB
+#define PASS_EDGE     0.4     //x fs_out
+#define PASS_RIPPLE   0.2     //dB
+#define STOP_EDGE     0.5     //x fs_out, the FIR alone has to hold this up to fs_out
+#define STOP_FIR_DB   -70.0
+#define STOP_CIC_DB   -65.0   //fs_out ~ 4 fs_out, folds through the CIC alias bands
+
+static uint16_t g_in[IN_COUNT];
+static int16_t g_out[OUT_COUNT + 1];
+static double g_ref[OUT_COUNT + 1];
+
+static void make_tone(double f_out, double phase)
+{
+    double w = 2 * M_PI * f_out / DECIMATOR_FACTOR;
+    int i;
+
+    for(i = 0; i < IN_COUNT; i++)
+        g_in[i] = (uint16_t)lrint(2048 + TONE_AMP * sin(w * i + phase));
+}
+
+//CIC in exact integer arithmetic, FIR in double, scaled to the 16-bit output
+static uint32_t reference(void)
+{
+    int64_t integrator[DECIMATOR_CIC_ORDER] = {0};
+    int64_t comb[DECIMATOR_CIC_ORDER] = {0};
+    double history[DECIMATOR_FIR_TAPS] = {0};
+    uint32_t count = 0;
+    int64_t value, prev;
+    double acc;
+    int i, j, phase = 0, fir_phase = 0;
+
+    for(i = 0; i < IN_COUNT; i++)
+    {
+        value = (int64_t)(g_in[i] & 0x0FFF) - 2048;
+
+        for(j = 0; j < DECIMATOR_CIC_ORDER; j++)
+        {
+            integrator[j] += value;
+            value = integrator[j];
+        }
+
+        if(++phase < DECIMATOR_CIC_FACTOR)
+            continue;
+
+        phase = 0;
+
+        for(j = 0; j < DECIMATOR_CIC_ORDER; j++)
+        {
+            prev = comb[j];
+            comb[j] = value;
+            value -= prev;
+        }
+
+        memmove(&history[1], &history[0], sizeof(double) * (DECIMATOR_FIR_TAPS - 1));
+        history[0] = (double)value / (1 << (2 * DECIMATOR_CIC_ORDER)) * 16;
+
+        if(++fir_phase < DECIMATOR_FIR_FACTOR)
+            continue;
+
+        fir_phase = 0;
+
+        for(acc = 0, j = 0; j < DECIMATOR_FIR_TAPS; j++)
+            acc += history[j] * g_decimator_fir[j] / 32768.0;
+
+        g_ref[count++] = acc;
+    }
+
+    return count;
+}
+
+//run the fixed-point decimator over the tone in DMA-sized blocks
+static uint32_t run(void)
+{
+    decimator_t dec;
+    uint32_t count = 0;
+    uint32_t i;
+
+    decimator_init(&dec);
+
+    for(i = 0; i < IN_COUNT; i += 1000)
+        count += decimator_process(&dec, &g_in[i], (IN_COUNT - i < 1000) ? IN_COUNT - i : 1000, &g_out[count]);
+
+    return count;
+}
+
+static double ac_rms_db(uint32_t count)
+{
+    double mean = 0, power = 0;
+    uint32_t i;
+
+    for(i = SETTLE; i < count; i++)
+        mean += g_out[i];
+
+    mean /= count - SETTLE;
+
+    for(i = SETTLE; i < count; i++)
+        power += (g_out[i] - mean) * (g_out[i] - mean);
+
+    power /= count - SETTLE;
+
+    return 10 * log10(power / (FULL_SCALE * FULL_SCALE / 2) + 1e-20);
+}
+
+int main(void)
+{
+    static const double pass[] = {0.01, 0.05, 0.1, 0.15, 0.2, 0.25, 0.3, 0.35, PASS_EDGE};
+    int fail = 0;
+    uint32_t count, ref_count, i;
+    double f, db, err, max_err, sum_err;
+    double worst_fir = -200, worst_cic = -200;
+
+    //bit accuracy against the double reference
+    make_tone(0.123, 0.3);
+    count = run();
+    ref_count = reference();
+
+    if(count != OUT_COUNT || ref_count != OUT_COUNT)
+    {
+        printf("output count %u, reference %u, expected %u\n", count, ref_count, OUT_COUNT);
+        return 1;
+    }
+
+    for(max_err = 0, sum_err = 0, i = 0; i < count; i++)
+    {
+        err = fabs(g_out[i] - g_ref[i]);
+        sum_err += err * err;
+        if(err > max_err)
+            max_err = err;
+    }
+
+    sum_err = sqrt(sum_err / count);
+    printf("reference   max %.2f LSB, rms %.2f LSB\n", max_err, sum_err);
+    if(max_err > REF_MAX_ERR || sum_err > REF_RMS_ERR)
+        fail++;
+
+    //passband, CIC droop compensated
+    for(i = 0; i < sizeof(pass) / sizeof(pass[0]); i++)
+    {
+        make_tone(pass[i], 0);
+        db = ac_rms_db(run());
+        printf("%.3f fs_out %8.3f dB\n", pass[i], db);
+        if(fabs(db) > PASS_RIPPLE)
+            fail++;
+    }
+
+    //stopband, every tone that would fold into 0 ~ 0.5 fs_out
+    for(f = STOP_EDGE; f < DECIMATOR_FACTOR / 2; f += 0.0137)
+    {
+        make_tone(f, 0);
+        db = ac_rms_db(run());
+
+        if(f < 1.0)
+        {
+            if(db > worst_fir)
+                worst_fir = db;
+            if(db > STOP_FIR_DB)
+                fail++;
+        }
+        else
+        {
+            if(db > worst_cic)
+                worst_cic = db;
+            if(db > STOP_CIC_DB)
+                fail++;
+        }
+    }
+
+    printf("stopband    %.1f dB worst in %.1f ~ 1 fs_out (limit %.0f)\n", worst_fir, STOP_EDGE, STOP_FIR_DB);
+    printf("            %.1f dB worst in 1 ~ %d fs_out (limit %.0f)\n", worst_cic, DECIMATOR_FACTOR / 2, STOP_CIC_DB);
+    printf("%s, %d failed\n", fail ? "FAIL" : "PASS", fail);
+
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,87 @@
+//--------------------------------------------------------------
+// file Name : fec_decode.c
+// XOR parity decoder for the fec=n stream option
+// parity = XOR of the n datagrams of a group, shorter ones zero padded,
+// so any single lost datagram is parity XOR the n-1 received ones
+//--------------------------------------------------------------
+#include <string.h>
+
+#include "fec_decode.h"
+
+static uint64_t fec_dec_get_be64(const unsigned char *p)
+{
+    uint64_t v = 0;
+    int i;
+
+    for(i = 0; i < 8; i++)
+        v = (v << 8) | p[i];
+
+    return v;
+}
+
+void fec_dec_init(fec_dec_t *dec)
+{
+    memset(dec, 0, sizeof(fec_dec_t));
+}
+
+int fec_dec_is_parity(const unsigned char *buf, int len)
+{
+    return (len >= FEC_DEC_HEADER_SIZE) && (buf[0] == 'F') && (buf[1] == 'E') && (buf[2] == 'C');
+}
+
+void fec_dec_add(fec_dec_t *dec, const unsigned char *buf, int len, uint64_t index)
+{
+    fec_dec_slot_t *slot = &dec->slot[dec->next];
+
+    if(len > FEC_DEC_DATAGRAM_MAX)
+        return;
+
+    slot->index = index;
+    slot->len = len;
+    memcpy(slot->data, buf, len);
+    dec->next = (dec->next + 1) % FEC_DEC_HISTORY;
+}
+
+int fec_dec_recover(fec_dec_t *dec, const unsigned char *parity, int len, unsigned char *out)
+{
+    int group = parity[3];
+    uint64_t first = fec_dec_get_be64(parity + 4);
+    uint64_t last = fec_dec_get_be64(parity + 12);
+    int len_xor = (parity[20] << 8) | parity[21];
+    int parity_len = (parity[22] << 8) | parity[23];
+    int present = 0;
+    int i, j;
+
+    if((parity_len > FEC_DEC_DATAGRAM_MAX) || (len < FEC_DEC_HEADER_SIZE + parity_len))
+        return -1;
+
+    memcpy(out, parity + FEC_DEC_HEADER_SIZE, parity_len);
+
+    for(i = 0; i < FEC_DEC_HISTORY; i++)
+    {
+        fec_dec_slot_t *slot = &dec->slot[i];
+
+        if((slot->len == 0) || (slot->index < first) || (slot->index > last) || (slot->len > parity_len))
+            continue;
+
+        for(j = 0; j < slot->len; j++)
+            out[j] ^= slot->data[j];
+
+        len_xor ^= slot->len;
+        present++;
+    }
+
+    if(present >= group)
+        return 0;
+
+    if((present != group - 1) || (len_xor == 0) || (len_xor > parity_len))
+    {
+        dec->failed++;
+        return -1;
+    }
+
+    dec->recovered++;
+    fec_dec_add(dec, out, len_xor, fec_dec_get_be64(out));
+
+    return len_xor;
+}
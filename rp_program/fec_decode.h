@@ -0,0 +1,42 @@
+//--------------------------------------------------------------
+// file Name : fec_decode.h
+// XOR parity decoder for the fec=n stream option
+// build with the receiver : cc -o mic_rec_test mic_rec_test.c fec_decode.c gap_track.c jitter_buf.c -lm
+//--------------------------------------------------------------
+#ifndef _FEC_DECODE_H_
+#define _FEC_DECODE_H_
+
+#include <stdint.h>
+
+#define FEC_DEC_HEADER_SIZE   24   //'FEC' group, first index(8), last index(8), length xor(2), parity length(2)
+#define FEC_DEC_DATAGRAM_MAX  1500
+#define FEC_DEC_HISTORY       64   //received datagrams kept, more than two of the largest group (16)
+
+typedef struct
+{
+    uint64_t index;                             //sample index from the timing header
+    int len;                                    //0 for an empty slot
+    unsigned char data[FEC_DEC_DATAGRAM_MAX];   //datagram as received, header included
+} fec_dec_slot_t;
+
+typedef struct
+{
+    fec_dec_slot_t slot[FEC_DEC_HISTORY];
+    int next;                //oldest slot, overwritten next
+    uint32_t recovered;      //datagrams rebuilt from parity
+    uint32_t failed;         //groups with more than one datagram lost
+} fec_dec_t;
+
+void fec_dec_init(fec_dec_t *dec);
+
+//1 if the datagram is a parity packet
+int fec_dec_is_parity(const unsigned char *buf, int len);
+
+//keep a received data datagram for later recovery
+void fec_dec_add(fec_dec_t *dec, const unsigned char *buf, int len, uint64_t index);
+
+//rebuild the one lost datagram of the group covered by a parity packet into out
+//return its length, 0 if nothing was lost, -1 if the group lost more than one
+int fec_dec_recover(fec_dec_t *dec, const unsigned char *parity, int len, unsigned char *out);
+
+#endif
@@ -0,0 +1,121 @@
+//--------------------------------------------------------------
+// file Name : gap_track.c
+// missing packet tracking for the loss count, and NACK requests for the nack=1 stream option
+// NACK : 'N' 'A' 'K' count, then count x 64-bit sample index, big endian
+//--------------------------------------------------------------
+#include <string.h>
+#include <sys/time.h>
+
+#include "gap_track.h"
+
+uint64_t gap_track_now_ms(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return (uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+void gap_track_init(gap_track_t *gap)
+{
+    memset(gap, 0, sizeof(gap_track_t));
+    gap->nack_ms = GAP_TRACK_HISTORY_MS;
+    gap->deadline_ms = GAP_TRACK_HISTORY_MS;
+}
+
+void gap_track_set_packet(gap_track_t *gap, uint64_t packet_samples, int rate, int fec_group)
+{
+    uint64_t history_ms, group_ms;
+
+    if(rate <= 0)
+        return;
+
+    history_ms = GAP_TRACK_HISTORY_DEPTH * packet_samples * 1000 / rate;
+    gap->nack_ms = (history_ms < GAP_TRACK_HISTORY_MS) ? history_ms : GAP_TRACK_HISTORY_MS;
+
+    //the parity packet follows the last data packet of the group
+    group_ms = (fec_group > 0) ? (fec_group + 1) * packet_samples * 1000 / rate + GAP_TRACK_RETRY_MS : 0;
+    gap->deadline_ms = (group_ms > gap->nack_ms) ? group_ms : gap->nack_ms;
+}
+
+void gap_track_add(gap_track_t *gap, uint64_t index, uint64_t now_ms)
+{
+    int i;
+
+    for(i = 0; i < GAP_TRACK_MAX; i++)
+    {
+        if(!gap->entry[i].used)
+        {
+            gap->entry[i].index = index;
+            gap->entry[i].first_ms = now_ms;
+            gap->entry[i].last_ms = 0;
+            gap->entry[i].used = 1;
+            return;
+        }
+    }
+}
+
+int gap_track_fill(gap_track_t *gap, uint64_t index)
+{
+    int i;
+
+    for(i = 0; i < GAP_TRACK_MAX; i++)
+    {
+        if(gap->entry[i].used && (gap->entry[i].index == index))
+        {
+            gap->entry[i].used = 0;
+            gap->filled++;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+void gap_track_expire(gap_track_t *gap, uint64_t now_ms)
+{
+    int i;
+
+    for(i = 0; i < GAP_TRACK_MAX; i++)
+    {
+        if(gap->entry[i].used && (now_ms - gap->entry[i].first_ms >= gap->deadline_ms))
+        {
+            gap->entry[i].used = 0;
+            gap->expired++;
+        }
+    }
+}
+
+int gap_track_nack(gap_track_t *gap, uint64_t now_ms, unsigned char *msg)
+{
+    int count = 0;
+    int i, j;
+
+    for(i = 0; (i < GAP_TRACK_MAX) && (count < GAP_TRACK_NACK_MAX); i++)
+    {
+        gap_track_entry_t *e = &gap->entry[i];
+
+        if(!e->used || (now_ms - e->first_ms >= gap->nack_ms))
+            continue;
+
+        if((e->last_ms != 0) && (now_ms - e->last_ms < GAP_TRACK_RETRY_MS))
+            continue;
+
+        e->last_ms = now_ms;
+        for(j = 0; j < 8; j++)
+            msg[4 + count * 8 + j] = (unsigned char)(e->index >> (56 - j * 8));
+        count++;
+    }
+
+    if(count == 0)
+        return 0;
+
+    msg[0] = 'N';
+    msg[1] = 'A';
+    msg[2] = 'K';
+    msg[3] = (unsigned char)count;
+    gap->requested += count;
+
+    return 4 + count * 8;
+}
@@ -0,0 +1,57 @@
+//--------------------------------------------------------------
+// file Name : gap_track.h
+// missing packet tracking for the loss count, and NACK requests for the nack=1 stream option
+// build with the receiver : cc -o mic_rec_test mic_rec_test.c fec_decode.c gap_track.c jitter_buf.c -lm
+//--------------------------------------------------------------
+#ifndef _GAP_TRACK_H_
+#define _GAP_TRACK_H_
+
+#include <stdint.h>
+
+#define GAP_TRACK_MAX          64    //missing packets tracked at once
+#define GAP_TRACK_RETRY_MS     20    //ask again if the packet has not arrived
+#define GAP_TRACK_HISTORY_MS   100   //device history, as RETX_HISTORY_MS
+#define GAP_TRACK_HISTORY_DEPTH 24   //packets at most, as RETX_HISTORY_DEPTH
+#define GAP_TRACK_NACK_MAX     32    //indexes per NACK, as RETX_NACK_INDEX_MAX on the device
+#define GAP_TRACK_NACK_SIZE    (4 + GAP_TRACK_NACK_MAX * 8)
+
+typedef struct
+{
+    uint64_t index;      //sample index of the missing packet
+    uint64_t first_ms;   //when the gap was seen
+    uint64_t last_ms;    //when it was last asked for, 0 if not yet
+    int used;
+} gap_track_entry_t;
+
+typedef struct
+{
+    gap_track_entry_t entry[GAP_TRACK_MAX];
+    uint64_t nack_ms;     //stop asking, the device history is gone by then
+    uint64_t deadline_ms; //forget the gap, no parity or late packet can fill it any more
+    uint32_t requested;  //NACK indexes sent
+    uint32_t filled;     //missing packets that arrived later
+    uint32_t expired;    //missing packets given up on
+} gap_track_t;
+
+uint64_t gap_track_now_ms(void);
+
+void gap_track_init(gap_track_t *gap);
+
+//size the NACK window to the device history, which holds fewer packets than GAP_TRACK_HISTORY_MS at high packet rates,
+//and keep gaps at least until the parity packet of their group is due
+void gap_track_set_packet(gap_track_t *gap, uint64_t packet_samples, int rate, int fec_group);
+
+//note a missing packet, dropped silently when the table is full
+void gap_track_add(gap_track_t *gap, uint64_t index, uint64_t now_ms);
+
+//a packet arrived late, return 1 if it was missing
+int gap_track_fill(gap_track_t *gap, uint64_t index);
+
+//drop gaps past the deadline, with or without NACKs
+void gap_track_expire(gap_track_t *gap, uint64_t now_ms);
+
+//build a NACK for every missing packet due a (re)request
+//return its length, 0 if nothing is due
+int gap_track_nack(gap_track_t *gap, uint64_t now_ms, unsigned char *msg);
+
+#endif
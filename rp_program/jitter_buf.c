@@ -0,0 +1,237 @@
+//--------------------------------------------------------------
+// file Name : jitter_buf.c
+// adaptive jitter buffer, loss concealment and clock recovery for 16-bit streams
+// the delay follows the interarrival jitter, the read speed follows the device clock
+// and is trimmed by the buffer level, so playout neither runs dry nor piles up
+//--------------------------------------------------------------
+#include <string.h>
+#include <math.h>
+
+#include "jitter_buf.h"
+
+#define JB_RING_MASK (JB_RING_GROUPS - 1)
+
+static void jitter_buf_restart(jitter_buf_t *jb, uint64_t index)
+{
+    memset(jb->valid, 0, sizeof(jb->valid));
+    jb->started = 0;
+    jb->pos = (double)index;
+    jb->cur_index = index;
+    jb->end_index = index;
+    jb->played = 0;
+    jb->fade = 1.0;
+    jb->transit_valid = 0;
+    jb->fit_n = jb->fit_t = jb->fit_x = jb->fit_tt = jb->fit_tx = 0;
+}
+
+//next group in playout order, a missing one repeats the last good group fading out
+static void jitter_buf_fetch(jitter_buf_t *jb, uint64_t index, double *dst)
+{
+    uint32_t slot = (uint32_t)(index & JB_RING_MASK);
+    int ch;
+
+    if(jb->valid[slot])
+    {
+        jb->valid[slot] = 0;
+        jb->fade = 1.0;
+        for(ch = 0; ch < jb->channels; ch++)
+            dst[ch] = jb->last[ch] = jb->ring[slot * JB_CH_MAX + ch];
+        return;
+    }
+
+    jb->fade *= JB_FADE;
+    jb->concealed++;
+    for(ch = 0; ch < jb->channels; ch++)
+        dst[ch] = jb->last[ch] * jb->fade;
+}
+
+static void jitter_buf_update_delay(jitter_buf_t *jb, uint64_t index, int count, uint64_t now_us)
+{
+    double transit, target;
+
+    //RFC 3550 interarrival jitter, both clocks in groups
+    transit = (double)now_us * jb->rate / 1000000.0 - (double)index;
+    if(jb->transit_valid)
+        jb->jitter += (fabs(transit - jb->transit) - jb->jitter) / 16.0;
+    jb->transit = transit;
+    jb->transit_valid = 1;
+
+    //one packet plus three times the jitter, up at once and down slowly
+    target = count + 3.0 * jb->jitter;
+    if(target < jb->target)
+        target = jb->target - (jb->target - target) / 256.0;
+    if(target < (double)jb->rate * JB_MIN_MS / 1000)
+        target = (double)jb->rate * JB_MIN_MS / 1000;
+    if(target > (double)jb->rate * JB_MAX_MS / 1000)
+        target = (double)jb->rate * JB_MAX_MS / 1000;
+    jb->target = (uint32_t)target;
+}
+
+static void jitter_buf_update_drift(jitter_buf_t *jb, uint64_t index, uint64_t now_us)
+{
+    double t, x, den;
+
+    if(jb->fit_n == 0)
+    {
+        jb->fit_index0 = index;
+        jb->fit_us0 = now_us;
+    }
+
+    t = (double)(now_us - jb->fit_us0) / 1000000.0;
+    x = (double)(int64_t)(index - jb->fit_index0);
+    jb->fit_n += 1;
+    jb->fit_t += t;
+    jb->fit_x += x;
+    jb->fit_tt += t * t;
+    jb->fit_tx += t * x;
+
+    //slope of device groups over host seconds, arrival jitter averages out
+    den = jb->fit_n * jb->fit_tt - jb->fit_t * jb->fit_t;
+    if((now_us - jb->fit_us0 >= JB_FIT_MIN_US) && (den > 0))
+        jb->drift = (jb->fit_n * jb->fit_tx - jb->fit_t * jb->fit_x) / den / jb->rate;
+}
+
+void jitter_buf_init(jitter_buf_t *jb, uint32_t rate, int channels)
+{
+    memset(jb, 0, sizeof(jitter_buf_t));
+
+    jb->rate = rate ? rate : 1;
+    jb->channels = ((channels > 0) && (channels <= JB_CH_MAX)) ? channels : 1;
+    jb->target = (uint32_t)((uint64_t)jb->rate * JB_MIN_MS / 1000);
+    jb->drift = 1.0;
+    jb->step = 1.0;
+    jb->fade = 1.0;
+}
+
+int jitter_buf_put(jitter_buf_t *jb, uint64_t index, const int16_t *samples, int count, uint64_t now_us)
+{
+    uint32_t slot;
+    int g;
+
+    if(count <= 0)
+        return -1;
+
+    //a jump the ring cannot hold either way, the device restarted or paused for long, start over
+    if(jb->fit_n == 0)
+    {
+        jitter_buf_restart(jb, index);
+    }
+    else if((index + count > jb->cur_index) ? (index + count - jb->cur_index > JB_RING_GROUPS) : (jb->cur_index - index > JB_RING_GROUPS))
+    {
+        jb->overflow++;
+        jitter_buf_restart(jb, index);
+    }
+
+    jitter_buf_update_delay(jb, index, count, now_us);
+    jitter_buf_update_drift(jb, index, now_us);
+
+    //before playout an older packet just moves the start back
+    if(!jb->started && (index < jb->cur_index) && (jb->end_index - index < JB_RING_GROUPS))
+    {
+        jb->cur_index = index;
+        jb->pos = (double)index;
+    }
+
+    //groups cur_index and cur_index + 1 are already taken for interpolation
+    if(jb->started && (index + count <= jb->cur_index + 2))
+    {
+        jb->late++;
+        return -1;
+    }
+
+    for(g = 0; g < count; g++)
+    {
+        if(jb->started && (index + g <= jb->cur_index + 1))
+            continue;
+        slot = (uint32_t)((index + g) & JB_RING_MASK);
+        memcpy(&jb->ring[slot * JB_CH_MAX], &samples[g * jb->channels], jb->channels * sizeof(int16_t));
+        jb->valid[slot] = 1;
+    }
+
+    if(index + count > jb->end_index)
+        jb->end_index = index + count;
+
+    //playout starts once the delay is buffered
+    if(!jb->started && (jb->end_index - jb->cur_index >= jb->target))
+    {
+        jb->started = 1;
+        jb->play_start_us = now_us;
+        jitter_buf_fetch(jb, jb->cur_index, jb->a);
+        jitter_buf_fetch(jb, jb->cur_index + 1, jb->b);
+    }
+
+    return 0;
+}
+
+uint32_t jitter_buf_due(const jitter_buf_t *jb, uint64_t now_us)
+{
+    uint64_t owed;
+
+    if(!jb->started)
+        return 0;
+
+    owed = (now_us - jb->play_start_us) * jb->rate / 1000000;
+
+    return (owed > jb->played) ? (uint32_t)(owed - jb->played) : 0;
+}
+
+int jitter_buf_get(jitter_buf_t *jb, int16_t *out, int count)
+{
+    double level, trim, f, v;
+    int n, ch;
+
+    if(!jb->started)
+        return 0;
+
+    //read at the device rate, trimmed towards the target level
+    level = (double)(int64_t)jb->end_index - jb->pos;
+    trim = (level - jb->target) / jb->rate * 0.01;
+    if(trim > JB_TRIM_MAX)
+        trim = JB_TRIM_MAX;
+    else if(trim < -JB_TRIM_MAX)
+        trim = -JB_TRIM_MAX;
+    jb->step = jb->drift * (1.0 + trim);
+
+    for(n = 0; n < count; n++)
+    {
+        f = jb->pos - (double)jb->cur_index;
+        while(f >= 1.0)
+        {
+            memcpy(jb->a, jb->b, sizeof(jb->a));
+            jb->cur_index++;
+            jitter_buf_fetch(jb, jb->cur_index + 1, jb->b);
+            f -= 1.0;
+        }
+
+        //linear interpolation, the step stays within a fraction of a percent of 1
+        for(ch = 0; ch < jb->channels; ch++)
+        {
+            v = jb->a[ch] + (jb->b[ch] - jb->a[ch]) * f;
+            if(v > 32767.0)
+                v = 32767.0;
+            else if(v < -32768.0)
+                v = -32768.0;
+            out[n * jb->channels + ch] = (int16_t)lrint(v);
+        }
+
+        jb->pos += jb->step;
+        jb->played++;
+    }
+
+    return count;
+}
+
+double jitter_buf_delay_ms(const jitter_buf_t *jb)
+{
+    return (double)jb->target * 1000.0 / jb->rate;
+}
+
+double jitter_buf_level_ms(const jitter_buf_t *jb)
+{
+    return ((double)(int64_t)jb->end_index - jb->pos) * 1000.0 / jb->rate;
+}
+
+double jitter_buf_drift_ppm(const jitter_buf_t *jb)
+{
+    return (jb->drift - 1.0) * 1000000.0;
+}
@@ -0,0 +1,78 @@
+//--------------------------------------------------------------
+// file Name : jitter_buf.h
+// adaptive jitter buffer, loss concealment and clock recovery for 16-bit streams
+// packets go in by sample index in any order, samples come out at the host rate
+// build with the receiver : cc -o mic_rec_test mic_rec_test.c fec_decode.c gap_track.c jitter_buf.c -lm
+//--------------------------------------------------------------
+#ifndef _JITTER_BUF_H_
+#define _JITTER_BUF_H_
+
+#include <stdint.h>
+
+#define JB_CH_MAX         4           //device ADC inputs
+#define JB_RING_GROUPS    (1 << 17)   //sample groups held, must be a power of two, about 1.3s at 96kS/s
+#define JB_MIN_MS         20          //smallest playout delay
+#define JB_MAX_MS         1000        //largest playout delay, below JB_RING_GROUPS at 96kS/s
+#define JB_FIT_MIN_US     2000000     //arrivals needed before the drift estimate is used
+#define JB_TRIM_MAX       0.005       //largest resampling correction from the buffer level, 5000 ppm
+#define JB_FADE           0.995       //per group attenuation of a concealed gap
+
+typedef struct
+{
+    //stream
+    uint32_t rate;                  //nominal sample rate, the host plays at this rate by its own clock
+    int channels;
+
+    //received samples, interleaved, slot = sample index & (JB_RING_GROUPS - 1)
+    int16_t ring[JB_RING_GROUPS * JB_CH_MAX];
+    uint8_t valid[JB_RING_GROUPS];
+    uint64_t end_index;             //one past the newest received group
+    int started;
+
+    //playout, pos is the fractional sample index being read
+    double pos;
+    uint64_t cur_index;             //groups a and b of the interpolation are cur_index and cur_index + 1
+    double a[JB_CH_MAX];
+    double b[JB_CH_MAX];
+    double last[JB_CH_MAX];         //last good group, faded while concealing
+    double fade;
+    uint64_t play_start_us;
+    uint64_t played;                //groups handed out since playout started
+
+    //adaptive delay from the RFC 3550 interarrival jitter, in groups
+    double jitter;
+    double transit;
+    int transit_valid;
+    uint32_t target;
+
+    //device sample clock against the host clock, least squares over all arrivals
+    uint64_t fit_index0, fit_us0;
+    double fit_n, fit_t, fit_x, fit_tt, fit_tx;
+    double drift;                   //device groups per host second / rate
+    double step;                    //input groups per output group
+
+    //statistics
+    uint32_t late;                  //packets behind the playout position
+    uint32_t overflow;              //restarts on a jump too far from the playout position
+    uint64_t concealed;             //groups played out without data
+} jitter_buf_t;
+
+void jitter_buf_init(jitter_buf_t *jb, uint32_t rate, int channels);
+
+//add a packet of count groups starting at index, received at now_us on the host clock
+//return 0, -1 if it came too late to be played. A jump the ring cannot hold restarts the buffer
+int jitter_buf_put(jitter_buf_t *jb, uint64_t index, const int16_t *samples, int count, uint64_t now_us);
+
+//groups the host clock asks for since playout started, 0 before the buffer has filled to its delay
+uint32_t jitter_buf_due(const jitter_buf_t *jb, uint64_t now_us);
+
+//play out count groups into out, gaps are concealed and the drift is resampled away
+//return the groups written, 0 before the buffer has filled to its delay
+int jitter_buf_get(jitter_buf_t *jb, int16_t *out, int count);
+
+//playout delay and buffer level in ms, drift in ppm
+double jitter_buf_delay_ms(const jitter_buf_t *jb);
+double jitter_buf_level_ms(const jitter_buf_t *jb);
+double jitter_buf_drift_ppm(const jitter_buf_t *jb);
+
+#endif
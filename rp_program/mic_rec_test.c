@@ -12,10 +12,70 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include<arpa/inet.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include <errno.h>
+
+#include "fec_decode.h"
+#include "gap_track.h"
+#include "jitter_buf.h"
 
 #define MAXLINE    2048
 #define BLOCK      255
 #define FILENAME "buf.dat"
+#define HDR_SIZE   16 //sample index(8) + capture time us(8), big endian
+#define SAMPLE_BYTES 2
+#define PLAY_RATE  16000 //device default
+#define PLAY_CHUNK 1024  //groups per jitter buffer read
+
+static uint64_t get_be64(const unsigned char *p)
+{
+    uint64_t v = 0;
+    int i;
+
+    for(i = 0; i < 8; i++)
+        v = (v << 8) | p[i];
+
+    return v;
+}
+
+static uint64_t host_now_us(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+//16-bit samples go through the jitter buffer, the play file gets them at the host clock rate
+static void play_packet(jitter_buf_t *jb, const char *buf, int nbyte, uint64_t sample_index, int channels)
+{
+    int16_t samples[MAXLINE / 2];
+
+    memcpy(samples, buf + HDR_SIZE, nbyte - HDR_SIZE);
+    jitter_buf_put(jb, sample_index, samples, (nbyte - HDR_SIZE) / (2 * channels), host_now_us());
+}
+
+static void play_out(jitter_buf_t *jb, FILE *play)
+{
+    int16_t out[PLAY_CHUNK * JB_CH_MAX];
+    uint32_t due;
+    int n;
+
+    for(due = jitter_buf_due(jb, host_now_us()); due > 0; due -= n)
+    {
+        n = jitter_buf_get(jb, out, (due > PLAY_CHUNK) ? PLAY_CHUNK : due);
+        fwrite(out, sizeof(int16_t) * jb->channels, n, play);
+    }
+}
+
+//samples land at their index, so lost packets leave silence and recovered ones fill it in later
+static void write_packet(FILE *stream, const char *buf, int nbyte, uint64_t offset_index, int group_bytes)
+{
+    fseek(stream, (long)(offset_index * group_bytes), SEEK_SET);
+    fwrite(buf + HDR_SIZE, sizeof(char), nbyte - HDR_SIZE, stream);
+}
 
 int main(int argc, char *argv[]) {
     struct sockaddr_in servaddr, cliaddr;
@@ -25,6 +85,30 @@ int main(int argc, char *argv[]) {
     char tcp_send_msg[100] = "start";
     int tcp_send_size = 0;
     char save_file_name[100];
+    int sample_bytes = SAMPLE_BYTES;
+    int channels = 1;
+    int fec_group = 0;
+    static fec_dec_t fec;
+    unsigned char fec_buf[FEC_DEC_DATAGRAM_MAX];
+    int fec_len;
+    int nack = 0;
+    static gap_track_t gap;
+    unsigned char nack_msg[GAP_TRACK_NACK_SIZE];
+    int nack_len;
+    uint64_t pkt_samples, idx;
+    struct timeval rcv_timeout;
+    static jitter_buf_t jb;
+    FILE *play = 0;
+    int play_rate = 0;
+
+    //timing header
+    uint64_t sample_index, capture_us;
+    uint64_t next_index = 0, first_index = 0, last_index = 0;
+    uint64_t first_us = 0, last_us = 0;
+    uint64_t lost_samples = 0;
+    uint32_t pkt_count = 0, gap_count = 0, reorder_count = 0;
+    struct timeval first_tv, last_tv;
+    double dev_sec, host_sec;
 
     int tcp_sock;
     struct sockaddr_in tcp_serv_addr;
@@ -32,7 +116,7 @@ int main(int argc, char *argv[]) {
     //파일명 포트번호
     if((argc ==2)&&(strcmp(argv[1],"/h") == 0))
     {
-        printf("help cmd [UDP PORT] [TCP IP] [TCP PORT] [FILE NAME]\r\n");
+        printf("help cmd [UDP PORT] [TCP IP] [TCP PORT] [FILE NAME] [BYTES PER SAMPLE] [CHANNELS] [FEC GROUP] [NACK 0|1] [PLAY FILE] [RATE]\r\n");
         return 0;
     }
     if(argc < 4) { 
@@ -47,6 +131,40 @@ int main(int argc, char *argv[]) {
     {
         strcpy(save_file_name , argv[4]);
     }
+    if(argc > 5)
+    {
+        sample_bytes = atoi(argv[5]);
+        if(sample_bytes <= 0)
+            sample_bytes = SAMPLE_BYTES;
+    }
+    if(argc > 6)
+    {
+        channels = atoi(argv[6]);
+        if(channels <= 0)
+            channels = 1;
+    }
+    if(argc > 7)
+    {
+        fec_group = atoi(argv[7]);
+        if(fec_group < 0)
+            fec_group = 0;
+    }
+    if(argc > 8)
+        nack = atoi(argv[8]) ? 1 : 0;
+    if(argc > 10)
+        play_rate = atoi(argv[10]);
+    //real-time playout, 16-bit samples only
+    if((argc > 9) && (sample_bytes == 2) && (channels <= JB_CH_MAX))
+    {
+        if((play = fopen(argv[9], "w")) == 0)
+        {
+            printf("play file open error\n");
+            exit(1);
+        }
+        jitter_buf_init(&jb, (play_rate > 0) ? play_rate : PLAY_RATE, channels);
+    }
+    fec_dec_init(&fec);
+    gap_track_init(&gap);
     printf("Save File name : [%s]\r\n", save_file_name);
     
     //소켓 생성 UDP
@@ -79,6 +197,11 @@ int main(int argc, char *argv[]) {
         perror("bind fail");
         exit(0);
     }
+
+    //wake up now and then to repeat NACKs even when nothing arrives
+    rcv_timeout.tv_sec = 0;
+    rcv_timeout.tv_usec = GAP_TRACK_RETRY_MS * 1000;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &rcv_timeout, sizeof(rcv_timeout));
     
 
     //저장용 파일 생성
@@ -87,14 +210,26 @@ int main(int argc, char *argv[]) {
         exit(1);
     }
     puts("Server : waiting request.");
-    tcp_send_size = sprintf(tcp_send_msg, "start %s", argv[1]);
+    tcp_send_size = sprintf(tcp_send_msg, "start %s ch=%d fec=%d nack=%d", argv[1], channels, fec_group, nack);
+    if(play_rate > 0)
+        tcp_send_size += sprintf(tcp_send_msg + tcp_send_size, " rate=%d", play_rate);
     write(tcp_sock, tcp_send_msg, tcp_send_size);
 
     while(1)
     {
         //puts("Server : waiting request.");
          //전송 받은 메시지 nbyte 저장
+        //gaps age out whether or not they are asked for, a full table would stop the loss count from being corrected
+        gap_track_expire(&gap, gap_track_now_ms());
+        //NACKs go back to the device port the stream comes from
+        if(nack && (pkt_count > 0) && ((nack_len = gap_track_nack(&gap, gap_track_now_ms(), nack_msg)) > 0))
+            sendto(s, nack_msg, nack_len, 0, (struct sockaddr *)&cliaddr, addrlen);
+        if(play)
+            play_out(&jb, play);
+
         nbyte = recvfrom(s, buf, MAXLINE , 0, (struct sockaddr *)&cliaddr, &addrlen);
+        if((nbyte < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+            continue;
         if(nbyte< 0) {
             perror("recvfrom fail");
             exit(1);
@@ -104,15 +239,107 @@ int main(int argc, char *argv[]) {
         //if(!strncmp(buf, "end of file", 10)) { //마지막 메시지가 end of file이면 종료
         if(!strncmp(buf, "STOP", 4))
         {
-            printf("file close");
+            printf("file close\r\n");
             fclose(stream); //stream 닫기
+            if(pkt_count > 1)
+            {
+                dev_sec = (double)(last_us - first_us) / 1000000.0;
+                host_sec = (double)(last_tv.tv_sec - first_tv.tv_sec) + (double)(last_tv.tv_usec - first_tv.tv_usec) / 1000000.0;
+                printf("packets %u, gaps %u (%llu samples lost), reordered %u, fec recovered %u, unrecoverable %u\r\n",
+                       pkt_count, gap_count, (unsigned long long)lost_samples, reorder_count, fec.recovered, fec.failed);
+                printf("nack requested %u, filled %u, expired %u\r\n", gap.requested, gap.filled, gap.expired);
+                if(dev_sec > 0)
+                    printf("device rate %.2f S/s, device/host clock %.1f ppm\r\n",
+                           (double)(last_index - first_index) / dev_sec, (dev_sec - host_sec) / host_sec * 1000000.0);
+            }
+            if(play)
+            {
+                printf("playout delay %.1f ms, level %.1f ms, drift %.1f ppm, concealed %llu, late %u, restarts %u\r\n",
+                       jitter_buf_delay_ms(&jb), jitter_buf_level_ms(&jb), jitter_buf_drift_ppm(&jb),
+                       (unsigned long long)jb.concealed, jb.late, jb.overflow);
+                fclose(play);
+            }
             break; //while문 빠져나가기
         } 
+        else if(fec_dec_is_parity((unsigned char *)buf, nbyte))
+        {
+            //rebuild the one packet a group may have lost, it was already counted as a gap
+            fec_len = fec_dec_recover(&fec, (unsigned char *)buf, nbyte, fec_buf);
+            if((fec_len > HDR_SIZE) && (pkt_count > 0))
+            {
+                sample_index = get_be64(fec_buf);
+                if(sample_index >= first_index)
+                {
+                    if(gap_track_fill(&gap, sample_index))
+                        lost_samples -= (fec_len - HDR_SIZE) / (sample_bytes * channels);
+                    write_packet(stream, (char *)fec_buf, fec_len, sample_index - first_index, sample_bytes * channels);
+                    if(play)
+                        play_packet(&jb, (char *)fec_buf, fec_len, sample_index, channels);
+                    printf("fec recovered %llu\r\n", (unsigned long long)sample_index);
+                }
+            }
+            else if(fec_len < 0)
+            {
+                printf("fec group lost more than one packet\r\n");
+            }
+        }
         else {
         	//printf("%d byte recv: %s\n",nbyte, buf);
-            printf("%d byte recv\r\n",nbyte);
+            if(nbyte < HDR_SIZE)
+                continue;
+
+            sample_index = get_be64((unsigned char *)buf);
+            capture_us = get_be64((unsigned char *)buf + 8);
+
+            //gap : samples missing, reorder : older than already received
+            pkt_samples = (nbyte - HDR_SIZE) / (sample_bytes * channels);
+            if((pkt_count > 0) && (sample_index > next_index))
+            {
+                gap_count++;
+                lost_samples += sample_index - next_index;
+                printf("gap at %llu, %llu samples\r\n", (unsigned long long)next_index, (unsigned long long)(sample_index - next_index));
+                //packets are the same size, each missing one starts a packet length after the previous
+                for(idx = next_index; (pkt_samples > 0) && (idx < sample_index); idx += pkt_samples)
+                    gap_track_add(&gap, idx, gap_track_now_ms());
+            }
+            else if((pkt_count > 0) && (sample_index < next_index))
+            {
+                if(gap_track_fill(&gap, sample_index))
+                {
+                    lost_samples -= pkt_samples;
+                    printf("late or resent %llu\r\n", (unsigned long long)sample_index);
+                }
+                else
+                {
+                    reorder_count++;
+                    printf("reorder at %llu\r\n", (unsigned long long)sample_index);
+                }
+            }
+
+            if(pkt_count == 0)
+            {
+                //NACKs stop once the device no longer holds the packet
+                gap_track_set_packet(&gap, pkt_samples, (play_rate > 0) ? play_rate : PLAY_RATE, fec_group);
+                first_index = sample_index;
+                first_us = capture_us;
+                gettimeofday(&first_tv, NULL);
+            }
+            if(sample_index >= next_index)
+            {
+                next_index = sample_index + pkt_samples;
+                last_index = sample_index;
+                last_us = capture_us;
+                gettimeofday(&last_tv, NULL);
+            }
+            pkt_count++;
+            fec_dec_add(&fec, (unsigned char *)buf, nbyte, sample_index);
+
+            printf("%d byte recv, index %llu, time %llu us\r\n",nbyte, (unsigned long long)sample_index, (unsigned long long)capture_us);
             //fputs(buf, stream); //파일로 저장
-            fwrite(buf, sizeof(char), nbyte, stream);
+            if(sample_index >= first_index)
+                write_packet(stream, buf, nbyte, sample_index - first_index, sample_bytes * channels);
+            if(play)
+                play_packet(&jb, buf, nbyte, sample_index, channels);
         }
     }
     #if 0
@@ -0,0 +1,279 @@
+//--------------------------------------------------------------
+// file Name : sample_convert_test.c
+// host reference check and benchmark for port/sample_convert
+// command : cc -O2 -I../port/sample_convert -o sample_convert_test sample_convert_test.c ../port/sample_convert/sample_convert.c
+// run : ./sample_convert_test, exit status 0 when every kernel matches the reference
+// the timings compare the kernels with the per-sample reference on the host only, not on the M0+
+//--------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "sample_convert.h"
+
+#define COUNT       4096     //samples per block, even
+#define BENCH_REPS  2000     //blocks per timing
+#define S24_MAX     0x007FFFFF
+#define S24_MIN     (-0x00800000)
+
+static const char *g_format_name[] = {"s8", "s16le", "s16be", "s24", "f32"};
+static const uint16_t g_gain[] = {SAMPLE_CONVERT_GAIN_UNITY, 0, 64, 300, 4096};
+
+//4-byte aligned, the +1 variants exercise the unaligned path
+static uint16_t g_raw[COUNT + 2] __attribute__((aligned(4)));
+static int16_t g_pcm[COUNT];
+static int32_t g_s32[COUNT];
+static uint8_t g_out[COUNT * 4 + 8] __attribute__((aligned(4)));
+static uint8_t g_ref[COUNT * 4 + 8] __attribute__((aligned(4)));
+
+static int32_t clamp24(int64_t value)
+{
+    if(value > S24_MAX)
+        return S24_MAX;
+    if(value < S24_MIN)
+        return S24_MIN;
+
+    return (int32_t)value;
+}
+
+//one 24-bit sample to the wire format, written out byte by byte
+static uint8_t *ref_put(uint8_t format, int32_t value, uint8_t *out)
+{
+    float f;
+    uint32_t u;
+
+    switch(format)
+    {
+    case SAMPLE_CONVERT_S8:
+        *out++ = (uint8_t)(value >> 16);
+        break;
+    case SAMPLE_CONVERT_S16_LE:
+        *out++ = (uint8_t)((value >> 8) & 0xFF);
+        *out++ = (uint8_t)((value >> 16) & 0xFF);
+        break;
+    case SAMPLE_CONVERT_S16_BE:
+        *out++ = (uint8_t)((value >> 16) & 0xFF);
+        *out++ = (uint8_t)((value >> 8) & 0xFF);
+        break;
+    case SAMPLE_CONVERT_S24_LE:
+        *out++ = (uint8_t)(value & 0xFF);
+        *out++ = (uint8_t)((value >> 8) & 0xFF);
+        *out++ = (uint8_t)((value >> 16) & 0xFF);
+        break;
+    case SAMPLE_CONVERT_F32_LE:
+        f = (float)((double)value / 8388608.0);
+        memcpy(&u, &f, 4);
+        *out++ = (uint8_t)u;
+        *out++ = (uint8_t)(u >> 8);
+        *out++ = (uint8_t)(u >> 16);
+        *out++ = (uint8_t)(u >> 24);
+        break;
+    }
+
+    return out;
+}
+
+//the definition of the conversion, one sample at a time
+static uint32_t ref_raw(uint8_t format, uint16_t gain, int err_mute, const uint16_t *in, uint32_t count, uint8_t *out, uint32_t *err_count)
+{
+    uint8_t *p = out;
+    int32_t centered;
+    uint32_t i;
+
+    for(i = 0; i < count; i++)
+    {
+        centered = (int32_t)(in[i] & SAMPLE_CONVERT_ADC_MASK) - SAMPLE_CONVERT_ADC_CENTER;
+
+        if(in[i] & SAMPLE_CONVERT_ADC_ERR)
+        {
+            (*err_count)++;
+            if(err_mute)
+                centered = 0;
+        }
+
+        //12-bit centered sample to 24-bit full scale, then Q8 gain
+        p = ref_put(format, clamp24((int64_t)centered * 4096 * gain / SAMPLE_CONVERT_GAIN_UNITY), p);
+    }
+
+    return (uint32_t)(p - out);
+}
+
+static uint32_t ref_pcm(uint8_t format, uint16_t gain, const int16_t *in, uint32_t count, uint8_t *out)
+{
+    uint8_t *p = out;
+    uint32_t i;
+
+    for(i = 0; i < count; i++)
+        p = ref_put(format, clamp24((int64_t)in[i] * 256 * gain / SAMPLE_CONVERT_GAIN_UNITY), p);
+
+    return (uint32_t)(p - out);
+}
+
+static uint32_t ref_s32(uint8_t format, uint16_t gain, const int32_t *in, uint32_t count, uint8_t *out)
+{
+    uint8_t *p = out;
+    int64_t value;
+    uint32_t i;
+
+    for(i = 0; i < count; i++)
+    {
+        //floor division, as the arithmetic shift of the kernel
+        value = ((int64_t)(in[i] >> 8) * gain) >> 8;
+        p = ref_put(format, clamp24(value), p);
+    }
+
+    return (uint32_t)(p - out);
+}
+
+static void fill(void)
+{
+    uint32_t i;
+
+    srand(1);
+
+    for(i = 0; i < COUNT + 2; i++)
+    {
+        //full 12-bit range with the edges, some words carry the ERR bit
+        g_raw[i] = (i < 4) ? (uint16_t)(i & 1 ? 0x0FFF : 0) : (uint16_t)(rand() & 0x0FFF);
+        if((rand() % 50) == 0)
+            g_raw[i] |= SAMPLE_CONVERT_ADC_ERR;
+    }
+
+    for(i = 0; i < COUNT; i++)
+    {
+        g_pcm[i] = (i < 2) ? (i ? INT16_MAX : INT16_MIN) : (int16_t)(rand() & 0xFFFF);
+        g_s32[i] = (i < 2) ? (i ? INT32_MAX : INT32_MIN) : (int32_t)(((uint32_t)rand() << 16) ^ (uint32_t)rand());
+    }
+}
+
+static int compare(const char *kind, uint8_t format, uint16_t gain, const char *variant, uint32_t len, uint32_t ref_len)
+{
+    uint32_t i;
+
+    if(len == ref_len && memcmp(g_out, g_ref, len) == 0)
+        return 0;
+
+    for(i = 0; i < len && i < ref_len && g_out[i] == g_ref[i]; i++)
+        ;
+
+    printf("%s %s gain %u %s: %u bytes, reference %u, first difference at byte %u\n",
+           kind, g_format_name[format], gain, variant, len, ref_len, i);
+
+    return 1;
+}
+
+static int check(void)
+{
+    sample_convert_t conv;
+    uint32_t len, ref_len, err_count, ref_err;
+    uint32_t g, offset, count;
+    uint8_t format;
+    int err_mute;
+    int fail = 0;
+
+    for(format = 0; format <= SAMPLE_CONVERT_FORMAT_MAX; format++)
+    {
+        for(g = 0; g < sizeof(g_gain) / sizeof(g_gain[0]); g++)
+        {
+            //aligned and even, unaligned input, odd count
+            for(offset = 0; offset < 2; offset++)
+            {
+                for(count = COUNT - 1; count <= COUNT; count++)
+                {
+                    for(err_mute = 0; err_mute < 2; err_mute++)
+                    {
+                        char variant[48];
+
+                        snprintf(variant, sizeof(variant), "offset %u count %u mute %d", offset, count, err_mute);
+
+                        sample_convert_init(&conv, format, g_gain[g], err_mute);
+                        len = sample_convert_raw(&conv, &g_raw[offset], count, g_out);
+                        ref_err = 0;
+                        ref_len = ref_raw(format, g_gain[g], err_mute, &g_raw[offset], count, g_ref, &ref_err);
+                        err_count = conv.err_count;
+
+                        fail += compare("raw", format, g_gain[g], variant, len, ref_len);
+                        if(err_count != ref_err)
+                        {
+                            printf("raw %s %s: err_count %u, reference %u\n", g_format_name[format], variant, err_count, ref_err);
+                            fail++;
+                        }
+                    }
+                }
+            }
+
+            sample_convert_init(&conv, format, g_gain[g], false);
+            len = sample_convert_pcm(&conv, g_pcm, COUNT, g_out);
+            ref_len = ref_pcm(format, g_gain[g], g_pcm, COUNT, g_ref);
+            fail += compare("pcm", format, g_gain[g], "", len, ref_len);
+
+            sample_convert_init(&conv, format, g_gain[g], false);
+            len = sample_convert_s32(&conv, g_s32, COUNT, g_out);
+            ref_len = ref_s32(format, g_gain[g], g_s32, COUNT, g_ref);
+            fail += compare("s32", format, g_gain[g], "", len, ref_len);
+        }
+    }
+
+    return fail;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void bench(void)
+{
+    sample_convert_t conv;
+    volatile uint32_t sink = 0;
+    uint32_t ref_err = 0;
+    double t0, t_kernel, t_ref;
+    uint16_t gain;
+    uint8_t format;
+    int g, i;
+
+    printf("\nraw block of %u samples, ns per sample (host)\n", COUNT);
+    printf("format  gain   kernel  reference  speedup\n");
+
+    for(format = 0; format <= SAMPLE_CONVERT_FORMAT_MAX; format++)
+    {
+        for(g = 0; g < 2; g++)
+        {
+            gain = g ? 300 : SAMPLE_CONVERT_GAIN_UNITY;
+            sample_convert_init(&conv, format, gain, true);
+
+            t0 = now_ns();
+            for(i = 0; i < BENCH_REPS; i++)
+                sink += sample_convert_raw(&conv, g_raw, COUNT, g_out);
+            t_kernel = (now_ns() - t0) / ((double)BENCH_REPS * COUNT);
+
+            t0 = now_ns();
+            for(i = 0; i < BENCH_REPS; i++)
+                sink += ref_raw(format, gain, 1, g_raw, COUNT, g_ref, &ref_err);
+            t_ref = (now_ns() - t0) / ((double)BENCH_REPS * COUNT);
+
+            printf("%-6s %5u %8.2f %10.2f %7.1fx\n", g_format_name[format], gain, t_kernel, t_ref, t_ref / t_kernel);
+        }
+    }
+
+    (void)sink;
+}
+
+int main(void)
+{
+    int fail;
+
+    fill();
+    fail = check();
+    printf("reference check: %s, %d mismatches\n", fail ? "FAIL" : "PASS", fail);
+
+    bench();
+
+    return fail ? 1 : 0;
+}